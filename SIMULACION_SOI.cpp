@@ -6,6 +6,30 @@
 #include <cctype>
 #include <queue>
 #include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <set>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <csignal>
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <cerrno>
+#include <ctime>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -20,16 +44,113 @@ struct Proceso {
     int tiempoRetorno = -1;
     int tiempoRestante;
     bool iniciado = false;
+    int cpu = 0; // CPU que ejecuto el proceso (simulacion multi-CPU)
+    int overhead = 0; // tiempo total gastado en cambios de contexto
+};
+
+struct Rafaga {
+    int duracion;
+    int dispositivo; // -1 para rafaga de CPU, id del dispositivo para E/S
+};
+
+// Proceso descrito como una secuencia de rafagas de CPU y E/S
+struct ProcesoES {
+    int pid;
+    int llegada;
+    vector<Rafaga> rafagas;
+    int inicio = -1;
+    int fin = -1;
+    int tiempoRespuesta = -1;
+    int tiempoEspera = 0;
+    int tiempoRetorno = -1;
+    int tiempoCPU = 0;
+    int tiempoES = 0;
+    int overhead = 0;
+};
+
+// Lo que pide un proceso al suspenderse: usar la CPU o un dispositivo durante un tiempo
+struct PeticionProceso {
+    int duracion;
+    int dispositivo; // -1 para CPU
+};
+
+// Corrutina de un proceso: el planificador la reanuda y ella entrega su siguiente peticion
+struct TareaProceso {
+    struct promise_type {
+        PeticionProceso peticion{0, -1};
+        
+        TareaProceso get_return_object() {
+            return TareaProceso{coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        suspend_always initial_suspend() noexcept { return {}; }
+        suspend_always final_suspend() noexcept { return {}; }
+        suspend_always yield_value(PeticionProceso siguiente) noexcept {
+            peticion = siguiente;
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { terminate(); }
+    };
+    
+    coroutine_handle<promise_type> handle;
+    
+    explicit TareaProceso(coroutine_handle<promise_type> h) : handle(h) {}
+    TareaProceso(TareaProceso&& otra) noexcept : handle(exchange(otra.handle, nullptr)) {}
+    TareaProceso(const TareaProceso&) = delete;
+    TareaProceso& operator=(const TareaProceso&) = delete;
+    ~TareaProceso() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+    
+    // Reanuda el proceso; devuelve false si ya no tiene mas rafagas
+    bool reanudar(PeticionProceso& peticion) {
+        handle.resume();
+        if (handle.done()) {
+            return false;
+        }
+        peticion = handle.promise().peticion;
+        return true;
+    }
+};
+
+struct UsoDispositivo {
+    int dispositivo;
+    long long ocupado = 0;
+};
+
+struct ResultadoES {
+    int tiempoTotal = 0;
+    int numCPUs = 1;
+    long long cpuOcupada = 0;
+    long long overhead = 0;
+    int migraciones = 0;
+    vector<UsoDispositivo> dispositivos;
 };
 
+enum TipoSolicitud { LIBERAR, ASIGNAR, REASIGNAR };
+
 struct SolicitudMemoria {
     int pid;
     int tam;
+    int tiempo = -1;     // -1: se asigna al iniciar el proceso
+    int tipo = ASIGNAR;
+    int bloque = -1;     // indice de la solicitud ASIGNAR a la que se refieren LIBERAR y REASIGNAR
+};
+
+// Costo de los cambios de contexto; con todo en cero los cambios son gratuitos
+struct ModeloCosto {
+    int despacho = 0;          // costo fijo de cada cambio de contexto
+    int penalizacionCache = 0; // costo extra con la cache completamente fria
+    int vidaMediaCache = 0;    // tiempo fuera de la CPU en que la cache pierde la mitad de su calor
+    int migracion = 0;         // costo extra al reanudar en una CPU distinta (multi-CPU)
 };
 
 struct ConfiguracionCPU {
     string algoritmo;
     int quantum;
+    ModeloCosto costo;
 };
 
 struct ConfiguracionMemoria {
@@ -37,6 +158,108 @@ struct ConfiguracionMemoria {
     string estrategia;
 };
 
+struct BloqueMemoria {
+    int inicio;
+    int tam;
+    int pid; // -1 si el bloque esta libre
+    int id = -1; // solicitud que creo el bloque
+};
+
+// Huecos ordenados por direccion en un treap que guarda el mayor tamaño de cada subarbol,
+// para encontrar el primer hueco que alcanza (first-fit) sin recorrer los anteriores
+struct IndiceHuecos {
+    struct Nodo {
+        int inicio;
+        int tam;
+        int mayor;          // mayor tamaño del subarbol
+        unsigned prioridad;
+        int izq = -1;
+        int der = -1;
+    };
+    vector<Nodo> nodos;
+    vector<int> libres;     // nodos borrados que se pueden reutilizar
+    int raiz = -1;
+    unsigned semilla = 2463534242u;
+};
+
+struct ResultadoMemoria {
+    int asignadas = 0;
+    int fallidas = 0;
+    int memoriaUsada = 0;
+    int memoriaLibre = 0;
+    int huecoMayor = 0;
+    int usoMaximo = 0;
+    int liberadas = 0;
+    int reasignadas = 0;
+    int descartadas = 0;         // solicitudes con tiempo en o despues del fin de su proceso
+    long long busquedas = 0;
+    long long pasosBusqueda = 0; // huecos revisados al buscar hueco
+    int pasosMaximos = 0;
+    vector<pair<int, int>> usoEnElTiempo; // (tiempo, memoria usada) tras cada cambio
+    map<int, BloqueMemoria> bloques;      // mapa de memoria por direccion de inicio
+    set<pair<int, int>> huecosPorTam;     // (tam, inicio) de cada hueco: best-fit y worst-fit
+    IndiceHuecos huecosPorDireccion;      // huecos por direccion: first-fit
+    set<pair<int, int>> bloquesPorId;     // (id, inicio) de cada bloque asignado
+    set<pair<int, int>> bloquesPorPID;    // (pid, inicio) de cada bloque asignado
+};
+
+// Evento con marca de tiempo para el asignador de memoria
+struct EventoMemoria {
+    int tiempo;
+    int fase;   // en un mismo instante: 0 = fin de proceso, 1 = inicio de proceso, 2 = programada
+    int pid;
+    int orden;  // posicion de la solicitud en la carga
+    int tipo;   // TipoSolicitud
+    int tam;
+    int bloque; // bloque afectado; -1 al liberar todo lo del proceso cuando termina
+    
+    // Orden total: el resultado no depende del orden en que se generaron los eventos
+    bool operator<(const EventoMemoria& otro) const {
+        if (tiempo != otro.tiempo) return tiempo < otro.tiempo;
+        if (fase != otro.fase) return fase < otro.fase;
+        // Las programadas siguen el orden de la carga; las de inicio y fin, el PID
+        if (fase != 2 && pid != otro.pid) return pid < otro.pid;
+        return orden < otro.orden;
+    }
+};
+
+struct ResultadoMultiCPU {
+    int tiempoTotal = 0;
+    vector<long long> ocupacionCPU; // tiempo de servicio ejecutado en cada CPU
+    vector<long long> overheadCPU;  // tiempo de cada CPU en cambios de contexto
+    vector<int> procesosPorCPU;
+    ResultadoMemoria memoria;
+};
+
+struct Metricas {
+    double promedioRespuesta = 0;
+    double promedioEspera = 0;
+    double promedioRetorno = 0;
+    double promedioOverhead = 0;
+};
+
+// Objetivo a minimizar por el optimizador de quantum
+struct ObjetivoQuantum {
+    string metrica;      // "respuesta", "espera" o "retorno"
+    string estadistico;  // "promedio" o "p99"
+    double costoCambio;  // costo de cada cambio de contexto, repartido entre los procesos
+};
+
+struct ResultadoOptimizacion {
+    int quantum = 0;
+    double valor = 0;
+    int evaluaciones = 0;
+    long long pasosSimulados = 0;
+    long long pasosReutilizados = 0;
+};
+
+// Carga de trabajo leida desde archivo (usada por el modo servicio)
+struct CargaTrabajo {
+    vector<Proceso> procesos;
+    vector<SolicitudMemoria> solicitudes;
+    uint64_t hash = 0;
+};
+
 // Funcion para limpiar el buffer de entrada
 void limpiarBuffer() {
     cin.clear();
@@ -71,6 +294,9 @@ void mostrarMenuPrincipal() {
     cout << "2. Gestion de Memoria\n";
     cout << "3. Simulacion Completa\n";
     cout << "4. Salir\n";
+    cout << "5. Optimizar Quantum de Round Robin\n";
+    cout << "6. Procesos con Rafagas de CPU y E/S\n";
+    cout << "7. Simulacion Multi-CPU\n";
     cout << "=========================================\n";
     cout << "Seleccione una opcion: ";
 }
@@ -111,9 +337,32 @@ void pausar() {
     cin.get();
 }
 
+// Funcion para leer un modelo de costo "costo=<despacho>,<penalizacion>,<vidaMedia>,<migracion>"
+// (cuatro enteros no negativos), de la linea de comandos o de una peticion del modo servicio
+bool interpretarModeloCosto(const string& opcion, ModeloCosto& costo) {
+    const string prefijo = "costo=";
+    if (opcion.compare(0, prefijo.size(), prefijo) != 0) {
+        return false;
+    }
+    
+    string valores = opcion.substr(prefijo.size());
+    replace(valores.begin(), valores.end(), ',', ' ');
+    istringstream campos(valores);
+    ModeloCosto leido;
+    string resto;
+    if (!(campos >> leido.despacho >> leido.penalizacionCache >> leido.vidaMediaCache >> leido.migracion) ||
+        (campos >> resto) || leido.despacho < 0 || leido.penalizacionCache < 0 ||
+        leido.vidaMediaCache < 0 || leido.migracion < 0) {
+        return false;
+    }
+    costo = leido;
+    return true;
+}
+
 // Funcion para solicitar configuracion de CPU con menu
-ConfiguracionCPU solicitarConfiguracionCPU() {
+ConfiguracionCPU solicitarConfiguracionCPU(const ModeloCosto& costo) {
     ConfiguracionCPU config;
+    config.costo = costo;
     int opcion;
     
     do {
@@ -161,8 +410,9 @@ ConfiguracionCPU solicitarConfiguracionCPU() {
 }
 
 // Funcion alternativa para solicitar configuracion CPU (estilo del segundo codigo)
-ConfiguracionCPU solicitarConfiguracionCPUCompleta() {
+ConfiguracionCPU solicitarConfiguracionCPUCompleta(const ModeloCosto& costo) {
     ConfiguracionCPU config;
+    config.costo = costo;
     
     cout << "\n=== CONFIGURACION DE CPU ===\n";
     
@@ -283,6 +533,126 @@ vector<Proceso> solicitarProcesos() {
     return procesos;
 }
 
+// Funcion para interpretar una secuencia de rafagas como "C5 E3:1 C2"
+// (C<duracion> para CPU, E<duracion>:<dispositivo> para E/S). Devuelve false si es invalida
+// o si no contiene ninguna rafaga de CPU.
+bool interpretarRafagas(const string& texto, vector<Rafaga>& rafagas) {
+    rafagas.clear();
+    istringstream tokens(texto);
+    string token;
+    
+    while (tokens >> token) {
+        char tipo = toupper(token[0]);
+        Rafaga rafaga;
+        char separador = ':';
+        istringstream campos(token.substr(1));
+        
+        if (tipo == 'C') {
+            rafaga.dispositivo = -1;
+            if (!(campos >> rafaga.duracion)) {
+                return false;
+            }
+        } else if (tipo == 'E') {
+            if (!(campos >> rafaga.duracion >> separador >> rafaga.dispositivo) ||
+                separador != ':' || rafaga.dispositivo < 0) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+        
+        if (rafaga.duracion <= 0 || campos.rdbuf()->in_avail() > 0) {
+            return false;
+        }
+        rafagas.push_back(rafaga);
+    }
+    
+    // Se necesita al menos una rafaga de CPU para medir el tiempo de respuesta
+    for (const auto& rafaga : rafagas) {
+        if (rafaga.dispositivo == -1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Funcion para solicitar procesos con rafagas de CPU y E/S
+vector<ProcesoES> solicitarProcesosES() {
+    vector<ProcesoES> procesos;
+    int numProcesos;
+    
+    cout << "\n==========================\n";
+    cout << "  PROCESOS CON RAFAGAS\n";
+    cout << "==========================\n";
+    cout << "Rafagas: C<duracion> para CPU, E<duracion>:<dispositivo> para E/S (ej: C5 E3:1 C2)\n";
+    
+    do {
+        cout << "Ingrese el numero de procesos: ";
+        cin >> numProcesos;
+        
+        if (cin.fail() || numProcesos <= 0) {
+            cout << "Error: Debe ingresar un numero entero positivo.\n";
+            limpiarBuffer();
+            numProcesos = -1;
+        }
+    } while (numProcesos <= 0);
+    
+    for (int i = 0; i < numProcesos; i++) {
+        ProcesoES proceso;
+        
+        cout << "\n--- Proceso " << (i + 1) << " ---\n";
+        
+        // PID
+        do {
+            cout << "PID: ";
+            cin >> proceso.pid;
+            
+            if (cin.fail() || proceso.pid <= 0) {
+                cout << "Error: El PID debe ser un numero entero positivo.\n";
+                limpiarBuffer();
+                proceso.pid = -1;
+            } else {
+                for (const auto& p : procesos) {
+                    if (p.pid == proceso.pid) {
+                        cout << "Error: El PID " << proceso.pid << " ya existe.\n";
+                        proceso.pid = -1;
+                        break;
+                    }
+                }
+            }
+        } while (proceso.pid <= 0);
+        
+        // Tiempo de llegada
+        do {
+            cout << "Tiempo de llegada: ";
+            cin >> proceso.llegada;
+            
+            if (cin.fail() || proceso.llegada < 0) {
+                cout << "Error: El tiempo de llegada debe ser un numero entero no negativo.\n";
+                limpiarBuffer();
+                proceso.llegada = -1;
+            }
+        } while (proceso.llegada < 0);
+        limpiarBuffer();
+        
+        // Rafagas
+        string texto;
+        do {
+            cout << "Rafagas: ";
+            getline(cin, texto);
+            
+            if (!interpretarRafagas(texto, proceso.rafagas)) {
+                cout << "Error: Secuencia de rafagas invalida.\n";
+                proceso.rafagas.clear();
+            }
+        } while (proceso.rafagas.empty());
+        
+        procesos.push_back(proceso);
+    }
+    
+    return procesos;
+}
+
 // Funcion para solicitar configuracion de memoria
 ConfiguracionMemoria solicitarConfiguracionMemoria() {
     ConfiguracionMemoria config;
@@ -444,90 +814,154 @@ vector<SolicitudMemoria> solicitarSolicitudesMemoria(const vector<Proceso>& proc
     return solicitudes;
 }
 
-// Funcion para simular Round Robin mejorada (del segundo codigo)
-void simularRoundRobin(vector<Proceso>& procesos, int quantum) {
-    int n = procesos.size();
-    vector<int> tiempoRestante(n);
+// Funcion para calcular el costo de poner un proceso en una CPU.
+// tiempoFuera es el tiempo que paso sin ejecutarse (-1 si nunca se ejecuto); la cache se
+// enfria a la mitad cada vidaMediaCache unidades y esta fria tras una migracion.
+int costoCambioContexto(const ModeloCosto& costo, int tiempoFuera, bool migra) {
+    int total = costo.despacho;
     
-    // Crear mapeo de PID a índice
-    vector<int> indicePorPID(1000, -1); // Asumiendo PIDs < 1000
-    for (int i = 0; i < n; i++) {
-        tiempoRestante[i] = procesos[i].servicio;
-        procesos[i].tiempoRestante = procesos[i].servicio;
-        indicePorPID[procesos[i].pid] = i;
+    if (tiempoFuera < 0 || migra || costo.vidaMediaCache <= 0) {
+        total += costo.penalizacionCache;
+    } else {
+        double frio = 1.0 - pow(0.5, static_cast<double>(tiempoFuera) / costo.vidaMediaCache);
+        total += static_cast<int>(lround(costo.penalizacionCache * frio));
     }
     
+    if (migra) {
+        total += costo.migracion;
+    }
+    return total;
+}
+
+// Estado de una simulacion Round Robin en curso; se puede copiar para reanudarla despues
+struct EstadoRoundRobin {
+    vector<Proceso> procesos;
+    vector<int> tiempoRestante;
+    vector<int> ultimaSalida; // ultima vez que cada proceso dejo la CPU, -1 si no ha corrido
     queue<int> colaListos;
-    vector<bool> enCola(n, false);
+    vector<bool> enCola;
+    vector<int> ordenLlegada;    // indices ordenados por (llegada, indice)
+    size_t siguienteLlegada = 0; // primer proceso de ordenLlegada que aun no entra a la cola
     int tiempoActual = 0;
     int procesosCompletados = 0;
-    // Agregar procesos iniciales
+    int ultimoProceso = -1;
+    int cambiosContexto = 0;
+};
+
+// Funcion para encolar, en orden de indice, los procesos que ya llegaron al tiempo actual
+void encolarLlegadas(EstadoRoundRobin& estado) {
+    vector<int> llegados;
+    while (estado.siguienteLlegada < estado.ordenLlegada.size() &&
+           estado.procesos[estado.ordenLlegada[estado.siguienteLlegada]].llegada <= estado.tiempoActual) {
+        llegados.push_back(estado.ordenLlegada[estado.siguienteLlegada++]);
+    }
+    sort(llegados.begin(), llegados.end());
+    for (int i : llegados) {
+        estado.colaListos.push(i);
+        estado.enCola[i] = true;
+    }
+}
+
+// Funcion para preparar el estado inicial de Round Robin
+EstadoRoundRobin iniciarRoundRobin(const vector<Proceso>& procesos) {
+    EstadoRoundRobin estado;
+    estado.procesos = procesos;
+    int n = procesos.size();
+    estado.tiempoRestante.resize(n);
+    estado.ultimaSalida.assign(n, -1);
+    estado.enCola.assign(n, false);
+    
     for (int i = 0; i < n; i++) {
-        if (procesos[i].llegada <= tiempoActual) {
-            colaListos.push(i);
-            enCola[i] = true;
-        }
+        estado.tiempoRestante[i] = procesos[i].servicio;
+        estado.procesos[i].tiempoRestante = procesos[i].servicio;
+        estado.ordenLlegada.push_back(i);
     }
+    stable_sort(estado.ordenLlegada.begin(), estado.ordenLlegada.end(), [&](int a, int b) {
+        return procesos[a].llegada < procesos[b].llegada;
+    });
     
-    while (procesosCompletados < n) {
-        if (colaListos.empty()) {
-            int siguienteLlegada = numeric_limits<int>::max();
-            for (int i = 0; i < n; i++) {
-                if (tiempoRestante[i] > 0 && procesos[i].llegada > tiempoActual) {
-                    siguienteLlegada = min(siguienteLlegada, procesos[i].llegada);
-                }
-            }
-            if (siguienteLlegada != numeric_limits<int>::max()) {
-                tiempoActual = siguienteLlegada;
-            }
-            
-            for (int i = 0; i < n; i++) {
-                if (procesos[i].llegada <= tiempoActual && !enCola[i] && tiempoRestante[i] > 0) {
-                    colaListos.push(i);
-                    enCola[i] = true;
-                }
-            }
-            continue;
-        }
-        
-        int procesoActual = colaListos.front();
-        colaListos.pop();
-        enCola[procesoActual] = false;
-        
-        if (!procesos[procesoActual].iniciado) {
-            procesos[procesoActual].inicio = tiempoActual;
-            procesos[procesoActual].tiempoRespuesta = tiempoActual - procesos[procesoActual].llegada;
-            procesos[procesoActual].iniciado = true;
-        }
-        
-        int tiempoEjecucion = min(quantum, tiempoRestante[procesoActual]);
-        tiempoRestante[procesoActual] -= tiempoEjecucion;
-        int tiempoAnterior = tiempoActual;
-        tiempoActual += tiempoEjecucion;
-        
-        for (int i = 0; i < n; i++) {
-            if (procesos[i].llegada > tiempoAnterior && 
-                procesos[i].llegada <= tiempoActual && 
-                !enCola[i] && tiempoRestante[i] > 0 && i != procesoActual) {
-                colaListos.push(i);
-                enCola[i] = true;
-            }
+    // Agregar procesos iniciales
+    encolarLlegadas(estado);
+    
+    return estado;
+}
+
+// Funcion para avanzar Round Robin un paso: un despacho o un salto a la siguiente llegada
+void pasoRoundRobin(EstadoRoundRobin& estado, int quantum, const ModeloCosto& costo) {
+    vector<Proceso>& procesos = estado.procesos;
+    vector<int>& tiempoRestante = estado.tiempoRestante;
+    queue<int>& colaListos = estado.colaListos;
+    vector<bool>& enCola = estado.enCola;
+    int& tiempoActual = estado.tiempoActual;
+    
+    if (colaListos.empty()) {
+        if (estado.siguienteLlegada < estado.ordenLlegada.size()) {
+            tiempoActual = procesos[estado.ordenLlegada[estado.siguienteLlegada]].llegada;
         }
-        
-        if (tiempoRestante[procesoActual] == 0) {
-            procesos[procesoActual].fin = tiempoActual;
-            procesos[procesoActual].tiempoRetorno = procesos[procesoActual].fin - procesos[procesoActual].llegada;
-            procesos[procesoActual].tiempoEspera = procesos[procesoActual].tiempoRetorno - procesos[procesoActual].servicio;
-            procesosCompletados++;
-        } else {
-            colaListos.push(procesoActual);
-            enCola[procesoActual] = true;
+        encolarLlegadas(estado);
+        return;
+    }
+    
+    int procesoActual = colaListos.front();
+    colaListos.pop();
+    enCola[procesoActual] = false;
+    
+    // Cargar otro proceso cuesta tiempo de CPU antes de que empiece a avanzar
+    if (estado.ultimoProceso != procesoActual) {
+        if (estado.ultimoProceso != -1) {
+            estado.cambiosContexto++;
         }
+        int salida = estado.ultimaSalida[procesoActual];
+        int cambio = costoCambioContexto(costo, salida < 0 ? -1 : tiempoActual - salida, false);
+        procesos[procesoActual].overhead += cambio;
+        tiempoActual += cambio;
+    }
+    estado.ultimoProceso = procesoActual;
+    
+    if (!procesos[procesoActual].iniciado) {
+        procesos[procesoActual].inicio = tiempoActual;
+        procesos[procesoActual].tiempoRespuesta = tiempoActual - procesos[procesoActual].llegada;
+        procesos[procesoActual].iniciado = true;
+    }
+    
+    int tiempoEjecucion = min(quantum, tiempoRestante[procesoActual]);
+    tiempoRestante[procesoActual] -= tiempoEjecucion;
+    tiempoActual += tiempoEjecucion;
+    estado.ultimaSalida[procesoActual] = tiempoActual;
+    
+    // Los que llegaron durante la rebanada entran antes que el proceso interrumpido
+    encolarLlegadas(estado);
+    
+    if (tiempoRestante[procesoActual] == 0) {
+        procesos[procesoActual].fin = tiempoActual;
+        procesos[procesoActual].tiempoRetorno = procesos[procesoActual].fin - procesos[procesoActual].llegada;
+        procesos[procesoActual].tiempoEspera = procesos[procesoActual].tiempoRetorno - procesos[procesoActual].servicio -
+                                               procesos[procesoActual].overhead;
+        estado.procesosCompletados++;
+    } else {
+        colaListos.push(procesoActual);
+        enCola[procesoActual] = true;
     }
 }
 
+// Funcion para saber si todos los procesos de Round Robin terminaron
+bool terminoRoundRobin(const EstadoRoundRobin& estado) {
+    return estado.procesosCompletados >= static_cast<int>(estado.procesos.size());
+}
+
+// Funcion para simular Round Robin mejorada (del segundo codigo)
+void simularRoundRobin(vector<Proceso>& procesos, int quantum, const ModeloCosto& costo) {
+    EstadoRoundRobin estado = iniciarRoundRobin(procesos);
+    
+    while (!terminoRoundRobin(estado)) {
+        pasoRoundRobin(estado, quantum, costo);
+    }
+    
+    procesos = move(estado.procesos);
+}
+
 // Funcion para simular FCFS
-void simularFCFS(vector<Proceso>& procesos) {
+void simularFCFS(vector<Proceso>& procesos, const ModeloCosto& costo) {
     sort(procesos.begin(), procesos.end(), 
          [](const Proceso& a, const Proceso& b) {
              return a.llegada < b.llegada;
@@ -540,18 +974,20 @@ void simularFCFS(vector<Proceso>& procesos) {
             tiempoActual = proceso.llegada;
         }
         
-        proceso.inicio = tiempoActual;
+        // Sin expropiacion cada proceso se carga una sola vez, con la cache fria
+        proceso.overhead = costoCambioContexto(costo, -1, false);
+        proceso.inicio = tiempoActual + proceso.overhead;
         proceso.tiempoRespuesta = proceso.inicio - proceso.llegada;
         proceso.fin = proceso.inicio + proceso.servicio;
         proceso.tiempoRetorno = proceso.fin - proceso.llegada;
-        proceso.tiempoEspera = proceso.tiempoRetorno - proceso.servicio;
+        proceso.tiempoEspera = proceso.tiempoRetorno - proceso.servicio - proceso.overhead;
         
         tiempoActual = proceso.fin;
     }
 }
 
 // Funcion para simular SPN (Shortest Process Next)
-void simularSPN(vector<Proceso>& procesos) {
+void simularSPN(vector<Proceso>& procesos, const ModeloCosto& costo) {
     int tiempoActual = 0;
     vector<bool> completado(procesos.size(), false);
     int procesosCompletados = 0;
@@ -590,11 +1026,12 @@ void simularSPN(vector<Proceso>& procesos) {
             tiempoActual = proceso.llegada;
         }
         
-        proceso.inicio = tiempoActual;
+        proceso.overhead = costoCambioContexto(costo, -1, false);
+        proceso.inicio = tiempoActual + proceso.overhead;
         proceso.tiempoRespuesta = proceso.inicio - proceso.llegada;
         proceso.fin = proceso.inicio + proceso.servicio;
         proceso.tiempoRetorno = proceso.fin - proceso.llegada;
-        proceso.tiempoEspera = proceso.tiempoRetorno - proceso.servicio;
+        proceso.tiempoEspera = proceso.tiempoRetorno - proceso.servicio - proceso.overhead;
         
         tiempoActual = proceso.fin;
         completado[indiceSeleccionado] = true;
@@ -605,84 +1042,1129 @@ void simularSPN(vector<Proceso>& procesos) {
 // Funcion para ejecutar la simulacion segun el algoritmo
 void ejecutarSimulacion(vector<Proceso>& procesos, const ConfiguracionCPU& configCPU) {
     if (configCPU.algoritmo == "rr") {
-        simularRoundRobin(procesos, configCPU.quantum);
+        simularRoundRobin(procesos, configCPU.quantum, configCPU.costo);
     } else if (configCPU.algoritmo == "fcfs") {
-        simularFCFS(procesos);
+        simularFCFS(procesos, configCPU.costo);
     } else if (configCPU.algoritmo == "spn") {
-        simularSPN(procesos);
+        simularSPN(procesos, configCPU.costo);
     } else {
         cout << "Algoritmo " << configCPU.algoritmo << " no implementado aun.\n";
         return;
     }
 }
 
-// Funcion para mostrar tabla de resultados
-void mostrarTablaResultados(const vector<Proceso>& procesos) {
-    cout << "\n=============================\n";
-    cout << "      TABLA DE RESULTADOS\n";
-    cout << "=============================\n";
-    cout << "PID | Llegada | Servicio | Inicio | Fin | Respuesta | Espera | Retorno\n";
-    cout << "----+---------+----------+--------+-----+-----------+--------+--------\n";
-    
-    vector<Proceso> procesosOrdenados = procesos;
-    sort(procesosOrdenados.begin(), procesosOrdenados.end(),
-         [](const Proceso& a, const Proceso& b) {
-             return a.pid < b.pid;
-         });
-    
-    for (const auto& proceso : procesosOrdenados) {
-        cout << setw(3) << proceso.pid << " |"
-             << setw(8) << proceso.llegada << " |"
-             << setw(9) << proceso.servicio << " |"
-             << setw(7) << proceso.inicio << " |"
-             << setw(4) << proceso.fin << " |"
-             << setw(10) << proceso.tiempoRespuesta << " |"
-             << setw(7) << proceso.tiempoEspera << " |"
-             << setw(7) << proceso.tiempoRetorno << endl;
+// Corrutina que recorre las rafagas de un proceso; el marco solo guarda el puntero y el indice
+TareaProceso ejecutarProceso(const ProcesoES* proceso) {
+    for (const auto& rafaga : proceso->rafagas) {
+        co_yield PeticionProceso{rafaga.duracion, rafaga.dispositivo};
     }
+}
+
+// Funcion para simular procesos con rafagas de CPU y E/S (FCFS, SPN o RR).
+// Cada proceso es una corrutina; las CPUs comparten la cola de listos, por lo que un proceso
+// puede migrar, y los dispositivos atienden su cola en orden de llegada.
+ResultadoES simularConES(vector<ProcesoES>& procesos, const ConfiguracionCPU& configCPU, int numCPUs) {
+    enum TipoEvento { LLEGADA = 0, FIN_ES = 1, FIN_CPU = 2 };
+    struct Evento {
+        int tiempo;
+        int tipo;
+        long long orden;
+        int indice; // proceso para LLEGADA, dispositivo para FIN_ES, CPU para FIN_CPU
+        bool operator>(const Evento& otro) const {
+            if (tiempo != otro.tiempo) return tiempo > otro.tiempo;
+            if (tipo != otro.tipo) return tipo > otro.tipo;
+            return orden > otro.orden;
+        }
+    };
+    struct Dispositivo {
+        int id;
+        queue<int> cola;
+        int enServicio = -1;
+        long long ocupado = 0;
+    };
+    
+    ResultadoES resultado;
+    resultado.numCPUs = numCPUs;
+    int n = procesos.size();
+    bool esRR = configCPU.algoritmo == "rr";
+    bool esSPN = configCPU.algoritmo == "spn";
     
-    double promedioRespuesta = 0, promedioEspera = 0, promedioRetorno = 0;
+    vector<TareaProceso> tareas;
+    tareas.reserve(n);
     for (const auto& proceso : procesos) {
-        promedioRespuesta += proceso.tiempoRespuesta;
-        promedioEspera += proceso.tiempoEspera;
-        promedioRetorno += proceso.tiempoRetorno;
+        tareas.push_back(ejecutarProceso(&proceso));
     }
     
-    int numProcesos = procesos.size();
-    promedioRespuesta /= numProcesos;
-    promedioEspera /= numProcesos;
-    promedioRetorno /= numProcesos;
-    
-    cout << "\n=============================\n";
-    cout << "          PROMEDIOS\n";
-    cout << "=============================\n";
-    cout << "Tiempo de Respuesta Promedio: " << fixed << setprecision(2) << promedioRespuesta << endl;
-    cout << "Tiempo de Espera Promedio: " << fixed << setprecision(2) << promedioEspera << endl;
-    cout << "Tiempo de Retorno Promedio: " << fixed << setprecision(2) << promedioRetorno << endl;
-}
-
-// Funcion para manejar planificacion de CPU
-void manejarPlanificacionCPU() {
-    ConfiguracionCPU configCPU = solicitarConfiguracionCPU();
+    vector<PeticionProceso> peticion(n);
+    vector<int> restante(n, 0);
+    vector<int> entradaListos(n, 0);
+    vector<int> ultimaCPU(n, -1);
+    vector<int> ultimaSalida(n, -1);
     
-    if (configCPU.algoritmo.empty()) {
-        return; // Usuario cancelo
+    vector<Dispositivo> dispositivos;
+    unordered_map<int, int> indiceDispositivo;
+    for (const auto& proceso : procesos) {
+        for (const auto& rafaga : proceso.rafagas) {
+            if (rafaga.dispositivo != -1 && !indiceDispositivo.count(rafaga.dispositivo)) {
+                indiceDispositivo[rafaga.dispositivo] = dispositivos.size();
+                Dispositivo dispositivo;
+                dispositivo.id = rafaga.dispositivo;
+                dispositivos.push_back(dispositivo);
+            }
+        }
     }
     
-    vector<Proceso> procesos = solicitarProcesos();
+    priority_queue<Evento, vector<Evento>, greater<Evento>> eventos;
+    long long orden = 0;
+    for (int i = 0; i < n; i++) {
+        eventos.push({procesos[i].llegada, LLEGADA, orden++, i});
+    }
     
-    cout << "\nEjecutando simulacion de " << configCPU.algoritmo << "...\n";
-    ejecutarSimulacion(procesos, configCPU);
+    // Cola de listos: FIFO para FCFS y RR, menor rafaga pendiente primero para SPN
+    queue<int> listosFIFO;
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> listosSPN;
+    auto encolarListo = [&](int i, int tiempo) {
+        entradaListos[i] = tiempo;
+        if (esSPN) {
+            listosSPN.push({restante[i], i});
+        } else {
+            listosFIFO.push(i);
+        }
+    };
     
-    mostrarTablaResultados(procesos);
-    pausar();
-}
-
-// Funcion para manejar gestion de memoria
-void manejarGestionMemoria() {
-    ConfiguracionMemoria configMemoria = solicitarConfiguracionMemoria();
+    auto iniciarServicio = [&](Dispositivo& dispositivo, int tiempo) {
+        int i = dispositivo.cola.front();
+        dispositivo.cola.pop();
+        dispositivo.enServicio = i;
+        dispositivo.ocupado += peticion[i].duracion;
+        eventos.push({tiempo + peticion[i].duracion, FIN_ES, orden++,
+                      indiceDispositivo[dispositivo.id]});
+    };
     
-    if (configMemoria.estrategia.empty()) {
+    // Reanuda la corrutina del proceso y atiende la peticion que entregue
+    auto avanzarProceso = [&](int i, int tiempo) {
+        if (!tareas[i].reanudar(peticion[i])) {
+            procesos[i].fin = tiempo;
+            procesos[i].tiempoRetorno = tiempo - procesos[i].llegada;
+            resultado.tiempoTotal = max(resultado.tiempoTotal, tiempo);
+            return;
+        }
+        
+        if (peticion[i].dispositivo == -1) {
+            restante[i] = peticion[i].duracion;
+            encolarListo(i, tiempo);
+        } else {
+            Dispositivo& dispositivo = dispositivos[indiceDispositivo[peticion[i].dispositivo]];
+            procesos[i].tiempoES += peticion[i].duracion;
+            dispositivo.cola.push(i);
+            if (dispositivo.enServicio == -1) {
+                iniciarServicio(dispositivo, tiempo);
+            }
+        }
+    };
+    
+    vector<int> enCPU(numCPUs, -1);
+    vector<int> rebanada(numCPUs, 0);
+    vector<int> ultimoEnCPU(numCPUs, -1);
+    while (!eventos.empty()) {
+        int tiempoActual = eventos.top().tiempo;
+        
+        // Atender todos los eventos de este instante antes de despachar
+        while (!eventos.empty() && eventos.top().tiempo == tiempoActual) {
+            Evento evento = eventos.top();
+            eventos.pop();
+            
+            if (evento.tipo == LLEGADA) {
+                avanzarProceso(evento.indice, tiempoActual);
+            } else if (evento.tipo == FIN_ES) {
+                Dispositivo& dispositivo = dispositivos[evento.indice];
+                int i = dispositivo.enServicio;
+                dispositivo.enServicio = -1;
+                if (!dispositivo.cola.empty()) {
+                    iniciarServicio(dispositivo, tiempoActual);
+                }
+                avanzarProceso(i, tiempoActual);
+            } else {
+                int cpu = evento.indice;
+                int i = enCPU[cpu];
+                enCPU[cpu] = -1;
+                ultimaSalida[i] = tiempoActual;
+                restante[i] -= rebanada[cpu];
+                if (restante[i] == 0) {
+                    avanzarProceso(i, tiempoActual);
+                } else {
+                    encolarListo(i, tiempoActual);
+                }
+            }
+        }
+        
+        for (int cpu = 0; cpu < numCPUs && (!listosFIFO.empty() || !listosSPN.empty()); cpu++) {
+            if (enCPU[cpu] != -1) {
+                continue;
+            }
+            
+            int i;
+            if (esSPN) {
+                i = listosSPN.top().second;
+                listosSPN.pop();
+            } else {
+                i = listosFIFO.front();
+                listosFIFO.pop();
+            }
+            
+            // Cambio de contexto: la cache se enfria fuera de la CPU y no viaja al migrar.
+            // Solo es gratis volver a despachar sin pausa al proceso que acaba de dejar esta CPU;
+            // tras E/S o un tiempo ocioso se cobra aunque nadie mas la haya usado.
+            int cambio = 0;
+            if (ultimoEnCPU[cpu] != i || ultimaSalida[i] != tiempoActual) {
+                bool migra = ultimaCPU[i] != -1 && ultimaCPU[i] != cpu;
+                int fuera = ultimaSalida[i] < 0 ? -1 : tiempoActual - ultimaSalida[i];
+                cambio = costoCambioContexto(configCPU.costo, fuera, migra);
+                if (migra) {
+                    resultado.migraciones++;
+                }
+            }
+            procesos[i].overhead += cambio;
+            resultado.overhead += cambio;
+            
+            if (procesos[i].inicio == -1) {
+                procesos[i].inicio = tiempoActual + cambio;
+                procesos[i].tiempoRespuesta = procesos[i].inicio - procesos[i].llegada;
+            }
+            procesos[i].tiempoEspera += tiempoActual - entradaListos[i];
+            
+            rebanada[cpu] = esRR ? min(configCPU.quantum, restante[i]) : restante[i];
+            procesos[i].tiempoCPU += rebanada[cpu];
+            resultado.cpuOcupada += rebanada[cpu];
+            enCPU[cpu] = i;
+            ultimoEnCPU[cpu] = i;
+            ultimaCPU[i] = cpu;
+            eventos.push({tiempoActual + cambio + rebanada[cpu], FIN_CPU, orden++, cpu});
+        }
+    }
+    
+    for (const auto& dispositivo : dispositivos) {
+        resultado.dispositivos.push_back({dispositivo.id, dispositivo.ocupado});
+    }
+    return resultado;
+}
+
+// Funcion para calcular los promedios de una simulacion ya ejecutada
+Metricas calcularMetricas(const vector<Proceso>& procesos) {
+    Metricas metricas;
+    if (procesos.empty()) {
+        return metricas;
+    }
+    
+    for (const auto& proceso : procesos) {
+        metricas.promedioRespuesta += proceso.tiempoRespuesta;
+        metricas.promedioEspera += proceso.tiempoEspera;
+        metricas.promedioRetorno += proceso.tiempoRetorno;
+        metricas.promedioOverhead += proceso.overhead;
+    }
+    
+    int numProcesos = procesos.size();
+    metricas.promedioRespuesta /= numProcesos;
+    metricas.promedioEspera /= numProcesos;
+    metricas.promedioRetorno /= numProcesos;
+    metricas.promedioOverhead /= numProcesos;
+    return metricas;
+}
+
+// Funcion para mostrar tabla de resultados
+void mostrarTablaResultados(const vector<Proceso>& procesos) {
+    cout << "\n=============================\n";
+    cout << "      TABLA DE RESULTADOS\n";
+    cout << "=============================\n";
+    cout << "PID | Llegada | Servicio | Inicio | Fin | Respuesta | Espera | Retorno | Overhead\n";
+    cout << "----+---------+----------+--------+-----+-----------+--------+---------+---------\n";
+    
+    vector<Proceso> procesosOrdenados = procesos;
+    sort(procesosOrdenados.begin(), procesosOrdenados.end(),
+         [](const Proceso& a, const Proceso& b) {
+             return a.pid < b.pid;
+         });
+    
+    for (const auto& proceso : procesosOrdenados) {
+        cout << setw(3) << proceso.pid << " |"
+             << setw(8) << proceso.llegada << " |"
+             << setw(9) << proceso.servicio << " |"
+             << setw(7) << proceso.inicio << " |"
+             << setw(4) << proceso.fin << " |"
+             << setw(10) << proceso.tiempoRespuesta << " |"
+             << setw(7) << proceso.tiempoEspera << " |"
+             << setw(8) << proceso.tiempoRetorno << " |"
+             << setw(8) << proceso.overhead << endl;
+    }
+    
+    Metricas metricas = calcularMetricas(procesos);
+    long long servicioTotal = 0, overheadTotal = 0;
+    for (const auto& proceso : procesos) {
+        servicioTotal += proceso.servicio;
+        overheadTotal += proceso.overhead;
+    }
+    
+    cout << "\n=============================\n";
+    cout << "          PROMEDIOS\n";
+    cout << "=============================\n";
+    cout << "Tiempo de Respuesta Promedio: " << fixed << setprecision(2) << metricas.promedioRespuesta << endl;
+    cout << "Tiempo de Espera Promedio: " << fixed << setprecision(2) << metricas.promedioEspera << endl;
+    cout << "Tiempo de Retorno Promedio: " << fixed << setprecision(2) << metricas.promedioRetorno << endl;
+    cout << "Overhead Promedio: " << fixed << setprecision(2) << metricas.promedioOverhead << endl;
+    if (overheadTotal > 0) {
+        cout << "Tiempo de CPU perdido en cambios de contexto: " << overheadTotal << " ("
+             << fixed << setprecision(2) << 100.0 * overheadTotal / (servicioTotal + overheadTotal) << "%)\n";
+    }
+}
+
+// Funcion para mostrar los resultados de la simulacion con rafagas de E/S
+void mostrarResultadosES(const vector<ProcesoES>& procesos, const ResultadoES& resultado) {
+    cout << "\n=============================\n";
+    cout << "      TABLA DE RESULTADOS\n";
+    cout << "=============================\n";
+    cout << "PID | Llegada | CPU | E/S | Inicio | Fin | Respuesta | Espera | Retorno | Overhead\n";
+    cout << "----+---------+-----+-----+--------+-----+-----------+--------+---------+---------\n";
+    
+    vector<ProcesoES> procesosOrdenados = procesos;
+    sort(procesosOrdenados.begin(), procesosOrdenados.end(),
+         [](const ProcesoES& a, const ProcesoES& b) {
+             return a.pid < b.pid;
+         });
+    
+    double promedioRespuesta = 0, promedioEspera = 0, promedioRetorno = 0, promedioOverhead = 0;
+    for (const auto& proceso : procesosOrdenados) {
+        cout << setw(3) << proceso.pid << " |"
+             << setw(8) << proceso.llegada << " |"
+             << setw(4) << proceso.tiempoCPU << " |"
+             << setw(4) << proceso.tiempoES << " |"
+             << setw(7) << proceso.inicio << " |"
+             << setw(4) << proceso.fin << " |"
+             << setw(10) << proceso.tiempoRespuesta << " |"
+             << setw(7) << proceso.tiempoEspera << " |"
+             << setw(8) << proceso.tiempoRetorno << " |"
+             << setw(8) << proceso.overhead << endl;
+        
+        promedioRespuesta += proceso.tiempoRespuesta;
+        promedioEspera += proceso.tiempoEspera;
+        promedioRetorno += proceso.tiempoRetorno;
+        promedioOverhead += proceso.overhead;
+    }
+    
+    int numProcesos = procesos.size();
+    cout << "\n=============================\n";
+    cout << "          PROMEDIOS\n";
+    cout << "=============================\n";
+    cout << "Tiempo de Respuesta Promedio: " << fixed << setprecision(2) << promedioRespuesta / numProcesos << endl;
+    cout << "Tiempo de Espera Promedio: " << fixed << setprecision(2) << promedioEspera / numProcesos << endl;
+    cout << "Tiempo de Retorno Promedio: " << fixed << setprecision(2) << promedioRetorno / numProcesos << endl;
+    cout << "Overhead Promedio: " << fixed << setprecision(2) << promedioOverhead / numProcesos << endl;
+    
+    cout << "\n=============================\n";
+    cout << "        UTILIZACION\n";
+    cout << "=============================\n";
+    double total = max(resultado.tiempoTotal, 1);
+    double capacidad = total * resultado.numCPUs;
+    cout << "CPU (trabajo util): " << fixed << setprecision(2) << 100.0 * resultado.cpuOcupada / capacidad << "%\n";
+    cout << "CPU (cambios de contexto): " << fixed << setprecision(2) << 100.0 * resultado.overhead / capacidad << "%\n";
+    if (resultado.numCPUs > 1) {
+        cout << "Migraciones: " << resultado.migraciones << endl;
+    }
+    for (const auto& uso : resultado.dispositivos) {
+        cout << "Dispositivo " << uso.dispositivo << ": " << fixed << setprecision(2)
+             << 100.0 * uso.ocupado / total << "%\n";
+    }
+}
+
+// Funcion para recalcular el mayor tamaño del subarbol de un nodo del indice de huecos
+void actualizarNodoHueco(IndiceHuecos& indice, int n) {
+    IndiceHuecos::Nodo& nodo = indice.nodos[n];
+    nodo.mayor = nodo.tam;
+    if (nodo.izq != -1) nodo.mayor = max(nodo.mayor, indice.nodos[nodo.izq].mayor);
+    if (nodo.der != -1) nodo.mayor = max(nodo.mayor, indice.nodos[nodo.der].mayor);
+}
+
+// Funcion para partir un subarbol en los huecos con inicio menor que el dado y el resto
+void dividirHuecos(IndiceHuecos& indice, int n, int inicio, int& menores, int& resto) {
+    if (n == -1) {
+        menores = resto = -1;
+        return;
+    }
+    if (indice.nodos[n].inicio < inicio) {
+        dividirHuecos(indice, indice.nodos[n].der, inicio, indice.nodos[n].der, resto);
+        menores = n;
+    } else {
+        dividirHuecos(indice, indice.nodos[n].izq, inicio, menores, indice.nodos[n].izq);
+        resto = n;
+    }
+    actualizarNodoHueco(indice, n);
+}
+
+// Funcion para unir dos subarboles; todos los huecos de a estan antes que los de b
+int unirHuecos(IndiceHuecos& indice, int a, int b) {
+    if (a == -1) return b;
+    if (b == -1) return a;
+    if (indice.nodos[a].prioridad > indice.nodos[b].prioridad) {
+        int der = unirHuecos(indice, indice.nodos[a].der, b);
+        indice.nodos[a].der = der;
+        actualizarNodoHueco(indice, a);
+        return a;
+    }
+    int izq = unirHuecos(indice, a, indice.nodos[b].izq);
+    indice.nodos[b].izq = izq;
+    actualizarNodoHueco(indice, b);
+    return b;
+}
+
+// Funcion para agregar un hueco al indice por direccion
+void insertarHueco(IndiceHuecos& indice, int inicio, int tam) {
+    // Prioridades pseudoaleatorias con semilla fija: el arbol y los pasos son reproducibles
+    indice.semilla ^= indice.semilla << 13;
+    indice.semilla ^= indice.semilla >> 17;
+    indice.semilla ^= indice.semilla << 5;
+    IndiceHuecos::Nodo nodo = {inicio, tam, tam, indice.semilla};
+    
+    int n;
+    if (indice.libres.empty()) {
+        n = indice.nodos.size();
+        indice.nodos.push_back(nodo);
+    } else {
+        n = indice.libres.back();
+        indice.libres.pop_back();
+        indice.nodos[n] = nodo;
+    }
+    
+    int menores, resto;
+    dividirHuecos(indice, indice.raiz, inicio, menores, resto);
+    indice.raiz = unirHuecos(indice, unirHuecos(indice, menores, n), resto);
+}
+
+// Funcion para quitar del indice por direccion el hueco que empieza en inicio
+void borrarHueco(IndiceHuecos& indice, int inicio) {
+    int menores, resto, elegido, mayores;
+    dividirHuecos(indice, indice.raiz, inicio, menores, resto);
+    dividirHuecos(indice, resto, inicio + 1, elegido, mayores);
+    if (elegido != -1) {
+        indice.libres.push_back(elegido);
+    }
+    indice.raiz = unirHuecos(indice, menores, mayores);
+}
+
+// Funcion para cambiar en su lugar el inicio y el tamaño de un hueco del subarbol. El nuevo
+// inicio no puede saltar a otro hueco, asi que el orden del arbol se conserva.
+void cambiarHueco(IndiceHuecos& indice, int n, int inicio, int inicioNuevo, int tamNuevo) {
+    IndiceHuecos::Nodo& nodo = indice.nodos[n];
+    if (inicio < nodo.inicio) {
+        cambiarHueco(indice, nodo.izq, inicio, inicioNuevo, tamNuevo);
+    } else if (inicio > nodo.inicio) {
+        cambiarHueco(indice, nodo.der, inicio, inicioNuevo, tamNuevo);
+    } else {
+        nodo.inicio = inicioNuevo;
+        nodo.tam = tamNuevo;
+    }
+    actualizarNodoHueco(indice, n);
+}
+
+// Funcion para encontrar el hueco de menor direccion que alcanza para tam; devuelve su
+// inicio o -1. Cada hueco revisado en el descenso cuenta como un paso.
+int primerHuecoQueAlcanza(const IndiceHuecos& indice, int tam, int& pasos) {
+    int n = indice.raiz;
+    if (n == -1 || indice.nodos[n].mayor < tam) {
+        return -1;
+    }
+    while (true) {
+        pasos++;
+        const IndiceHuecos::Nodo& nodo = indice.nodos[n];
+        if (nodo.izq != -1 && indice.nodos[nodo.izq].mayor >= tam) {
+            n = nodo.izq;
+        } else if (nodo.tam >= tam) {
+            return nodo.inicio;
+        } else {
+            n = nodo.der;
+        }
+    }
+}
+
+// Funcion para agregar un bloque al mapa de memoria y a sus indices
+void agregarBloque(ResultadoMemoria& memoria, const BloqueMemoria& bloque) {
+    memoria.bloques[bloque.inicio] = bloque;
+    if (bloque.pid == -1) {
+        memoria.huecosPorTam.insert({bloque.tam, bloque.inicio});
+        insertarHueco(memoria.huecosPorDireccion, bloque.inicio, bloque.tam);
+    } else {
+        memoria.bloquesPorId.insert({bloque.id, bloque.inicio});
+        memoria.bloquesPorPID.insert({bloque.pid, bloque.inicio});
+    }
+}
+
+// Funcion para quitar del mapa de memoria y de sus indices el bloque que empieza en inicio
+BloqueMemoria quitarBloque(ResultadoMemoria& memoria, int inicio) {
+    auto it = memoria.bloques.find(inicio);
+    BloqueMemoria bloque = it->second;
+    memoria.bloques.erase(it);
+    if (bloque.pid == -1) {
+        memoria.huecosPorTam.erase({bloque.tam, bloque.inicio});
+        borrarHueco(memoria.huecosPorDireccion, bloque.inicio);
+    } else {
+        memoria.bloquesPorId.erase({bloque.id, bloque.inicio});
+        memoria.bloquesPorPID.erase({bloque.pid, bloque.inicio});
+    }
+    return bloque;
+}
+
+// Funcion para cambiar el inicio y el tamaño de un hueco sin cruzar otros bloques, como
+// cuando se ocupa su principio o se une con un vecino; reutiliza los nodos de los indices
+void redimensionarHueco(ResultadoMemoria& memoria, int inicio, int inicioNuevo, int tamNuevo) {
+    auto nodoBloque = memoria.bloques.extract(inicio);
+    int tam = nodoBloque.mapped().tam;
+    nodoBloque.key() = inicioNuevo;
+    nodoBloque.mapped().inicio = inicioNuevo;
+    nodoBloque.mapped().tam = tamNuevo;
+    memoria.bloques.insert(move(nodoBloque));
+    
+    auto nodoTam = memoria.huecosPorTam.extract({tam, inicio});
+    nodoTam.value() = {tamNuevo, inicioNuevo};
+    memoria.huecosPorTam.insert(move(nodoTam));
+    
+    cambiarHueco(memoria.huecosPorDireccion, memoria.huecosPorDireccion.raiz, inicio, inicioNuevo, tamNuevo);
+}
+
+// Funcion para buscar un hueco segun la estrategia; devuelve su inicio o -1 si no hay.
+// First-fit desciende por el indice de huecos por direccion, con un paso por hueco revisado;
+// best-fit y worst-fit consultan el indice por tamaño, lo que cuenta como un solo paso.
+// Entre huecos del mismo tamaño se elige siempre el de menor direccion.
+int buscarHueco(ResultadoMemoria& memoria, int tam, const string& estrategia) {
+    int inicioElegido = -1;
+    int pasos = 0;
+    
+    if (estrategia == "first-fit") {
+        inicioElegido = primerHuecoQueAlcanza(memoria.huecosPorDireccion, tam, pasos);
+    } else if (!memoria.huecosPorTam.empty()) {
+        pasos = 1;
+        // best-fit: el menor hueco que alcanza; worst-fit: el mayor hueco
+        int tamBuscado = estrategia == "best-fit" ? tam : prev(memoria.huecosPorTam.end())->first;
+        auto it = memoria.huecosPorTam.lower_bound({tamBuscado, numeric_limits<int>::min()});
+        if (it != memoria.huecosPorTam.end() && it->first >= tam) {
+            inicioElegido = it->second;
+        }
+    }
+    
+    memoria.busquedas++;
+    memoria.pasosBusqueda += pasos;
+    memoria.pasosMaximos = max(memoria.pasosMaximos, pasos);
+    return inicioElegido;
+}
+
+// Funcion para ocupar el inicio de un hueco; el resto queda libre
+void ocuparHueco(ResultadoMemoria& memoria, int inicio, int pid, int tam, int id) {
+    int tamHueco = memoria.bloques.at(inicio).tam;
+    if (tamHueco > tam) {
+        redimensionarHueco(memoria, inicio, inicio + tam, tamHueco - tam);
+    } else {
+        quitarBloque(memoria, inicio);
+    }
+    agregarBloque(memoria, {inicio, tam, pid, id});
+    
+    memoria.memoriaUsada += tam;
+    memoria.usoMaximo = max(memoria.usoMaximo, memoria.memoriaUsada);
+}
+
+// Funcion para devolver un bloque al espacio libre, uniendolo con sus huecos vecinos
+void soltarBloque(ResultadoMemoria& memoria, int inicio) {
+    BloqueMemoria bloque = quitarBloque(memoria, inicio);
+    memoria.memoriaUsada -= bloque.tam;
+    
+    auto siguiente = memoria.bloques.lower_bound(inicio);
+    bool siguienteLibre = siguiente != memoria.bloques.end() && siguiente->second.pid == -1;
+    bool anteriorLibre = siguiente != memoria.bloques.begin() && prev(siguiente)->second.pid == -1;
+    
+    if (anteriorLibre) {
+        // El hueco anterior crece hasta cubrir el bloque y, si lo hay, el hueco siguiente
+        const BloqueMemoria& anterior = prev(siguiente)->second;
+        int tam = anterior.tam + bloque.tam;
+        if (siguienteLibre) {
+            tam += quitarBloque(memoria, siguiente->first).tam;
+        }
+        redimensionarHueco(memoria, anterior.inicio, anterior.inicio, tam);
+    } else if (siguienteLibre) {
+        // El hueco siguiente se extiende hacia atras
+        redimensionarHueco(memoria, siguiente->first, inicio, siguiente->second.tam + bloque.tam);
+    } else {
+        agregarBloque(memoria, {inicio, bloque.tam, -1});
+    }
+}
+
+// Funcion para buscar un bloque asignado por su identificador; devuelve su inicio o -1 si
+// no existe. Si varios bloques comparten identificador se toma el de menor direccion.
+int buscarBloque(const ResultadoMemoria& memoria, int id) {
+    auto it = memoria.bloquesPorId.lower_bound({id, numeric_limits<int>::min()});
+    if (it == memoria.bloquesPorId.end() || it->first != id) {
+        return -1;
+    }
+    return it->second;
+}
+
+// Funcion para asignar un bloque contiguo segun la estrategia; devuelve false si no hay hueco
+bool asignarMemoria(ResultadoMemoria& memoria, int pid, int tam, const string& estrategia, int id) {
+    int inicio = buscarHueco(memoria, tam, estrategia);
+    if (inicio == -1) {
+        memoria.fallidas++;
+        return false;
+    }
+    
+    ocuparHueco(memoria, inicio, pid, tam, id);
+    memoria.asignadas++;
+    return true;
+}
+
+// Funcion para liberar todos los bloques de un proceso, uniendo huecos vecinos
+void liberarMemoria(ResultadoMemoria& memoria, int pid) {
+    auto it = memoria.bloquesPorPID.lower_bound({pid, numeric_limits<int>::min()});
+    while (it != memoria.bloquesPorPID.end() && it->first == pid) {
+        soltarBloque(memoria, it->second);
+        memoria.liberadas++;
+        it = memoria.bloquesPorPID.lower_bound({pid, numeric_limits<int>::min()});
+    }
+}
+
+// Funcion para liberar un bloque concreto; devuelve false si ya no estaba asignado
+bool liberarBloque(ResultadoMemoria& memoria, int id) {
+    int inicio = buscarBloque(memoria, id);
+    if (inicio == -1) {
+        return false;
+    }
+    
+    soltarBloque(memoria, inicio);
+    memoria.liberadas++;
+    return true;
+}
+
+// Funcion para cambiar el tamaño de un bloque. Intenta hacerlo en su lugar y, si no cabe,
+// lo mueve a otro hueco; si no hay hueco el bloque original se conserva.
+bool reasignarBloque(ResultadoMemoria& memoria, int pid, int id, int tam, const string& estrategia) {
+    int inicio = buscarBloque(memoria, id);
+    if (inicio == -1) {
+        // Como realloc(NULL, tam): equivale a una asignacion nueva
+        return asignarMemoria(memoria, pid, tam, estrategia, id);
+    }
+    
+    BloqueMemoria& bloque = memoria.bloques.at(inicio);
+    int actual = bloque.tam;
+    auto siguiente = memoria.bloques.find(inicio + actual);
+    bool siguienteLibre = siguiente != memoria.bloques.end() && siguiente->second.pid == -1;
+    
+    if (tam <= actual || (siguienteLibre && actual + siguiente->second.tam >= tam)) {
+        // En su lugar: el hueco siguiente absorbe o cede la diferencia
+        int libre = actual - tam + (siguienteLibre ? siguiente->second.tam : 0);
+        bloque.tam = tam;
+        if (siguienteLibre && libre > 0) {
+            redimensionarHueco(memoria, siguiente->first, inicio + tam, libre);
+        } else if (siguienteLibre) {
+            quitarBloque(memoria, siguiente->first);
+        } else if (libre > 0) {
+            agregarBloque(memoria, {inicio + tam, libre, -1});
+        }
+        memoria.memoriaUsada += tam - actual;
+        memoria.usoMaximo = max(memoria.usoMaximo, memoria.memoriaUsada);
+        memoria.reasignadas++;
+        return true;
+    }
+    
+    // Mover: el bloque nuevo se ocupa antes de soltar el viejo, como en un realloc real
+    int destino = buscarHueco(memoria, tam, estrategia);
+    if (destino == -1) {
+        memoria.fallidas++;
+        return false;
+    }
+    
+    ocuparHueco(memoria, destino, pid, tam, id);
+    soltarBloque(memoria, inicio);
+    memoria.reasignadas++;
+    return true;
+}
+
+// Funcion para calcular la memoria libre y el hueco mayor del mapa actual
+void resumirMemoria(ResultadoMemoria& memoria) {
+    memoria.memoriaLibre = 0;
+    memoria.huecoMayor = 0;
+    for (const auto& hueco : memoria.huecosPorTam) {
+        memoria.memoriaLibre += hueco.first;
+    }
+    if (!memoria.huecosPorTam.empty()) {
+        memoria.huecoMayor = prev(memoria.huecosPorTam.end())->first;
+    }
+}
+
+// Funcion para simular la asignacion contigua de memoria segun la estrategia
+ResultadoMemoria simularMemoria(const vector<SolicitudMemoria>& solicitudes, const ConfiguracionMemoria& configMemoria) {
+    ResultadoMemoria resultado;
+    agregarBloque(resultado, {0, configMemoria.tam, -1});
+    
+    for (size_t i = 0; i < solicitudes.size(); i++) {
+        asignarMemoria(resultado, solicitudes[i].pid, solicitudes[i].tam, configMemoria.estrategia, i);
+    }
+    
+    resumirMemoria(resultado);
+    return resultado;
+}
+
+// Funcion para aplicar un evento de memoria al mapa del asignador
+void aplicarEventoMemoria(ResultadoMemoria& memoria, const EventoMemoria& evento, const string& estrategia) {
+    if (evento.tipo == LIBERAR && evento.bloque == -1) {
+        liberarMemoria(memoria, evento.pid);
+    } else if (evento.tipo == LIBERAR) {
+        liberarBloque(memoria, evento.bloque);
+    } else if (evento.tipo == ASIGNAR) {
+        asignarMemoria(memoria, evento.pid, evento.tam, estrategia, evento.bloque);
+    } else {
+        reasignarBloque(memoria, evento.pid, evento.bloque, evento.tam, estrategia);
+    }
+    
+    // Historial de uso: un punto por instante, solo cuando el uso cambia
+    vector<pair<int, int>>& historial = memoria.usoEnElTiempo;
+    if (!historial.empty() && historial.back().first == evento.tiempo) {
+        historial.back().second = memoria.memoriaUsada;
+    } else if (historial.empty() || historial.back().second != memoria.memoriaUsada) {
+        historial.push_back({evento.tiempo, memoria.memoriaUsada});
+    }
+}
+
+// Funcion para convertir en eventos las solicitudes de memoria de procesos ya planificados.
+// Las solicitudes sin tiempo se asignan cuando el proceso inicia y todo proceso que pida
+// memoria libera lo que le quede al terminar. Las solicitudes con tiempo se acotan a la vida
+// del proceso: las anteriores a su inicio se aplican al iniciar y las que caen en su fin o
+// despues se descartan, porque el proceso ya no existe y su memoria ya fue liberada.
+vector<EventoMemoria> construirEventosMemoria(const vector<Proceso>& procesos,
+                                              const vector<SolicitudMemoria>& solicitudes, int& descartadas) {
+    unordered_map<int, const Proceso*> procesoPorPID;
+    for (const auto& proceso : procesos) {
+        procesoPorPID[proceso.pid] = &proceso;
+    }
+    
+    vector<EventoMemoria> eventos;
+    unordered_map<int, bool> liberarAlTerminar;
+    for (size_t i = 0; i < solicitudes.size(); i++) {
+        const SolicitudMemoria& solicitud = solicitudes[i];
+        auto it = procesoPorPID.find(solicitud.pid);
+        if (it == procesoPorPID.end()) {
+            descartadas++;
+            continue;
+        }
+        const Proceso& proceso = *it->second;
+        
+        if (solicitud.tiempo < 0) {
+            eventos.push_back({proceso.inicio, 1, proceso.pid, static_cast<int>(i), ASIGNAR,
+                               solicitud.tam, static_cast<int>(i)});
+        } else if (solicitud.tiempo >= proceso.fin) {
+            descartadas++;
+            continue;
+        } else {
+            int bloque = solicitud.tipo == ASIGNAR ? static_cast<int>(i) : solicitud.bloque;
+            eventos.push_back({max(solicitud.tiempo, proceso.inicio), 2, proceso.pid, static_cast<int>(i),
+                               solicitud.tipo, solicitud.tam, bloque});
+        }
+        
+        // Una reasignacion de un bloque inexistente asigna uno nuevo, que tambien se libera al final
+        if (solicitud.tipo != LIBERAR && !liberarAlTerminar[proceso.pid]) {
+            liberarAlTerminar[proceso.pid] = true;
+            eventos.push_back({proceso.fin, 0, proceso.pid, 0, LIBERAR, 0, -1});
+        }
+    }
+    
+    sort(eventos.begin(), eventos.end());
+    return eventos;
+}
+
+// Funcion para procesar como flujo ordenado en el tiempo las solicitudes de memoria de
+// procesos ya planificados: asignaciones al iniciar o en su tiempo, liberaciones y
+// reasignaciones explicitas, y liberacion de lo que quede cuando cada proceso termina.
+ResultadoMemoria simularMemoriaTemporal(const vector<Proceso>& procesos, const vector<SolicitudMemoria>& solicitudes,
+                                        const ConfiguracionMemoria& configMemoria) {
+    ResultadoMemoria resultado;
+    agregarBloque(resultado, {0, configMemoria.tam, -1});
+    
+    vector<EventoMemoria> eventos = construirEventosMemoria(procesos, solicitudes, resultado.descartadas);
+    for (const auto& evento : eventos) {
+        aplicarEventoMemoria(resultado, evento, configMemoria.estrategia);
+    }
+    
+    resumirMemoria(resultado);
+    return resultado;
+}
+
+// Funcion para simular varias CPUs con un asignador de memoria compartido.
+// Los procesos se reparten por orden de llegada entre las CPUs y cada CPU planifica su cola
+// con el algoritmo elegido; un proceso no cambia de CPU. La memoria se simula despues como
+// el flujo ordenado de eventos de todos los procesos ya planificados.
+ResultadoMultiCPU simularMultiCPU(vector<Proceso>& procesos, const vector<SolicitudMemoria>& solicitudes,
+                                  const ConfiguracionCPU& configCPU, const ConfiguracionMemoria& configMemoria,
+                                  int numCPUs) {
+    ResultadoMultiCPU resultado;
+    resultado.ocupacionCPU.assign(numCPUs, 0);
+    resultado.overheadCPU.assign(numCPUs, 0);
+    resultado.procesosPorCPU.assign(numCPUs, 0);
+    
+    // Reparto por orden de llegada
+    vector<int> ordenLlegada(procesos.size());
+    for (size_t i = 0; i < procesos.size(); i++) {
+        ordenLlegada[i] = i;
+    }
+    sort(ordenLlegada.begin(), ordenLlegada.end(), [&](int a, int b) {
+        if (procesos[a].llegada != procesos[b].llegada) return procesos[a].llegada < procesos[b].llegada;
+        return procesos[a].pid < procesos[b].pid;
+    });
+    
+    vector<vector<int>> particiones(numCPUs);
+    unordered_map<int, int> indicePorPID;
+    for (size_t k = 0; k < ordenLlegada.size(); k++) {
+        int i = ordenLlegada[k];
+        procesos[i].cpu = k % numCPUs;
+        particiones[k % numCPUs].push_back(i);
+        indicePorPID[procesos[i].pid] = i;
+    }
+    
+    for (int cpu = 0; cpu < numCPUs; cpu++) {
+        vector<Proceso> locales;
+        for (int i : particiones[cpu]) {
+            locales.push_back(procesos[i]);
+        }
+        ejecutarSimulacion(locales, configCPU);
+        
+        for (const auto& proceso : locales) {
+            procesos[indicePorPID.at(proceso.pid)] = proceso;
+            resultado.ocupacionCPU[cpu] += proceso.servicio;
+            resultado.overheadCPU[cpu] += proceso.overhead;
+        }
+        resultado.procesosPorCPU[cpu] = locales.size();
+    }
+    
+    for (const auto& proceso : procesos) {
+        resultado.tiempoTotal = max(resultado.tiempoTotal, proceso.fin);
+    }
+    resultado.memoria = simularMemoriaTemporal(procesos, solicitudes, configMemoria);
+    return resultado;
+}
+
+// Funcion para calcular el porcentaje de asignaciones y reasignaciones que fallaron
+double calcularTasaFallos(const ResultadoMemoria& memoria) {
+    int intentos = memoria.asignadas + memoria.reasignadas + memoria.fallidas;
+    return intentos == 0 ? 0.0 : 100.0 * memoria.fallidas / intentos;
+}
+
+// Funcion para calcular la latencia promedio de busqueda de hueco, en bloques revisados
+double calcularPasosPromedio(const ResultadoMemoria& memoria) {
+    return memoria.busquedas == 0 ? 0.0 : static_cast<double>(memoria.pasosBusqueda) / memoria.busquedas;
+}
+
+// Funcion para mostrar el mapa de memoria resultante
+void mostrarResultadosMemoria(const ResultadoMemoria& resultado) {
+    cout << "\n=============================\n";
+    cout << "       MAPA DE MEMORIA\n";
+    cout << "=============================\n";
+    cout << " Inicio |    Tam | PID\n";
+    cout << "--------+--------+------\n";
+    
+    for (const auto& entrada : resultado.bloques) {
+        const BloqueMemoria& bloque = entrada.second;
+        cout << setw(7) << bloque.inicio << " |"
+             << setw(7) << bloque.tam << " | ";
+        if (bloque.pid == -1) {
+            cout << "libre\n";
+        } else {
+            cout << bloque.pid << "\n";
+        }
+    }
+    
+    cout << "\nSolicitudes asignadas: " << resultado.asignadas << endl;
+    cout << "Solicitudes fallidas: " << resultado.fallidas << endl;
+    cout << "Memoria usada: " << resultado.memoriaUsada << " bytes (maximo: "
+         << resultado.usoMaximo << " bytes)\n";
+    cout << "Memoria libre: " << resultado.memoriaLibre << " bytes (hueco mayor: "
+         << resultado.huecoMayor << " bytes)\n";
+    cout << "Liberaciones: " << resultado.liberadas << ", reasignaciones: " << resultado.reasignadas << endl;
+    if (resultado.descartadas > 0) {
+        cout << "Solicitudes descartadas (fuera de la vida de su proceso): " << resultado.descartadas << endl;
+    }
+    cout << "Tasa de fallos: " << fixed << setprecision(2) << calcularTasaFallos(resultado) << "%\n";
+    cout << "Latencia de asignacion: " << fixed << setprecision(2) << calcularPasosPromedio(resultado)
+         << " pasos promedio, " << resultado.pasosMaximos << " maximo\n";
+    
+    const vector<pair<int, int>>& historial = resultado.usoEnElTiempo;
+    if (historial.size() < 2) {
+        return;
+    }
+    
+    // Uso maximo por intervalo, a lo sumo 10 intervalos entre el primer y el ultimo cambio
+    cout << "\n=============================\n";
+    cout << "     USO EN EL TIEMPO\n";
+    cout << "=============================\n";
+    cout << "  Desde |  Hasta | Uso maximo\n";
+    cout << "--------+--------+-----------\n";
+    
+    int desde = historial.front().first;
+    int hasta = historial.back().first;
+    int ancho = max(1, (hasta - desde + 10) / 10);
+    size_t k = 0;
+    int usoPrevio = 0;
+    for (int inicio = desde; inicio <= hasta; inicio += ancho) {
+        int fin = inicio + ancho;
+        int maximo = usoPrevio; // lo que estaba asignado al comenzar el intervalo
+        while (k < historial.size() && historial[k].first < fin) {
+            usoPrevio = historial[k].second;
+            maximo = max(maximo, usoPrevio);
+            k++;
+        }
+        cout << setw(7) << inicio << " |" << setw(7) << fin - 1 << " |" << setw(10) << maximo << endl;
+    }
+}
+
+// Funcion para evaluar el objetivo sobre una simulacion Round Robin terminada
+double evaluarObjetivo(const EstadoRoundRobin& estado, const ObjetivoQuantum& objetivo) {
+    vector<int> valores;
+    for (const auto& proceso : estado.procesos) {
+        if (objetivo.metrica == "respuesta") {
+            valores.push_back(proceso.tiempoRespuesta);
+        } else if (objetivo.metrica == "espera") {
+            valores.push_back(proceso.tiempoEspera);
+        } else {
+            valores.push_back(proceso.tiempoRetorno);
+        }
+    }
+    
+    double valor = 0;
+    if (objetivo.estadistico == "p99") {
+        // Percentil 99 por rango mas cercano
+        sort(valores.begin(), valores.end());
+        size_t rango = static_cast<size_t>(ceil(0.99 * valores.size()));
+        valor = valores[max<size_t>(rango, 1) - 1];
+    } else {
+        for (int v : valores) {
+            valor += v;
+        }
+        valor /= valores.size();
+    }
+    
+    return valor + objetivo.costoCambio * estado.cambiosContexto / estado.procesos.size();
+}
+
+// Funcion para buscar el quantum de Round Robin que minimiza el objetivo.
+// Se simula una vez la referencia con un quantum "infinito" y se parte en periodos de
+// ocupacion (tramos entre dos momentos en que la CPU queda sin procesos). Si un candidato q
+// llega al inicio de un periodo con los mismos procesos terminados que la referencia y q no
+// cambia ningun despacho del periodo, ese periodo se planifica igual que en la referencia:
+// se copian sus resultados y solo se simulan los periodos donde q si cambia algo. Un despacho
+// no cambia si su rafaga cabe en q, o si corre solo (nadie espera ni llega mientras corre) y
+// por lo tanto Round Robin lo vuelve a despachar sin costo hasta que termina.
+// Ademas, cada candidato del barrido geometrico coincide con la referencia hasta su primer
+// despacho que si cambia; la referencia guarda su estado justo antes de ese punto (uno por
+// muestra del barrido) y cada candidato se reanuda desde el ultimo punto valido para su q.
+ResultadoOptimizacion optimizarQuantum(const vector<Proceso>& procesos, const ObjetivoQuantum& objetivo,
+                                       const ModeloCosto& costo) {
+    struct PeriodoOcupacion {
+        int inicio = 0;            // llegada que abre el periodo
+        int fin = 0;               // instante en que la CPU vuelve a quedar libre
+        int completadosAntes = 0;  // procesos terminados al empezar el periodo
+        int rafagaMaxima = 0;      // el periodo solo se reutiliza con quantum >= rafagaMaxima
+                                   // (sin contar las rafagas de procesos que corren solos)
+        int ultimoProceso = -1;
+        int cambiosContexto = 0;
+        long long pasos = 0;
+        vector<int> procesos;      // indices de los procesos del periodo
+    };
+    struct PuntoControl {
+        int quantumMinimo;         // el prefijo es valido para quantum >= quantumMinimo
+        long long pasos;           // pasos de la referencia antes de este punto
+        EstadoRoundRobin estado;
+    };
+    
+    ResultadoOptimizacion resultado;
+    
+    int quantumMaximo = 1;
+    for (const auto& proceso : procesos) {
+        quantumMaximo = max(quantumMaximo, proceso.servicio);
+    }
+    
+    vector<int> llegadas;
+    for (const auto& proceso : procesos) {
+        llegadas.push_back(proceso.llegada);
+    }
+    sort(llegadas.begin(), llegadas.end());
+    
+    // Barrido geometrico 1, 2, 4, ... hasta quantumMaximo; se fija antes de la referencia
+    vector<int> muestras;
+    for (int q = 1; q < quantumMaximo; q *= 2) {
+        muestras.push_back(q);
+    }
+    muestras.push_back(quantumMaximo);
+    
+    // Simulacion de referencia: con quantumMaximo ningun proceso es interrumpido
+    vector<PeriodoOcupacion> periodos;
+    vector<PuntoControl> puntosControl;
+    int rafagaMaximaPrefijo = 0; // mayor rafaga de un despacho que no corre solo, hasta ahora
+    long long pasos = 0;
+    EstadoRoundRobin referencia = iniciarRoundRobin(procesos);
+    int cambiosAlInicio = 0;
+    while (!terminoRoundRobin(referencia)) {
+        if (referencia.colaListos.empty() || periodos.empty()) {
+            periodos.emplace_back();
+            periodos.back().completadosAntes = referencia.procesosCompletados;
+            cambiosAlInicio = referencia.cambiosContexto;
+        }
+        
+        PeriodoOcupacion& periodo = periodos.back();
+        if (!referencia.colaListos.empty()) {
+            int despachado = referencia.colaListos.front();
+            if (periodo.procesos.empty()) {
+                periodo.inicio = referencia.procesos[despachado].llegada;
+            }
+            periodo.procesos.push_back(despachado);
+            
+            // En la referencia cada proceso se despacha una sola vez y con la cache fria
+            int rafaga = referencia.tiempoRestante[despachado];
+            int fin = referencia.tiempoActual + rafaga;
+            if (referencia.ultimoProceso != despachado) {
+                fin += costoCambioContexto(costo, -1, false);
+            }
+            
+            // Una llegada antes del final del despacho lo haria ceder la CPU con un quantum menor
+            bool solo = referencia.colaListos.size() == 1 &&
+                        upper_bound(llegadas.begin(), llegadas.end(), referencia.tiempoActual) ==
+                        lower_bound(llegadas.begin(), llegadas.end(), fin);
+            if (!solo) {
+                periodo.rafagaMaxima = max(periodo.rafagaMaxima, rafaga);
+                
+                // Primer punto de divergencia de alguna muestra q con rafagaMaximaPrefijo <= q < rafaga
+                auto muestra = lower_bound(muestras.begin(), muestras.end(), rafagaMaximaPrefijo);
+                if (rafaga > rafagaMaximaPrefijo && muestra != muestras.end() && *muestra < rafaga) {
+                    puntosControl.push_back({rafagaMaximaPrefijo, pasos, referencia});
+                }
+                rafagaMaximaPrefijo = max(rafagaMaximaPrefijo, rafaga);
+            }
+        }
+        
+        pasoRoundRobin(referencia, quantumMaximo, costo);
+        pasos++;
+        periodo.pasos++;
+        periodo.fin = referencia.tiempoActual;
+        periodo.ultimoProceso = referencia.ultimoProceso;
+        periodo.cambiosContexto = referencia.cambiosContexto - cambiosAlInicio;
+        resultado.pasosSimulados++;
+    }
+    resultado.evaluaciones = 1;
+    
+    map<int, double> memo;
+    memo[quantumMaximo] = evaluarObjetivo(referencia, objetivo);
+    
+    auto evaluar = [&](int quantum) {
+        auto it = memo.find(quantum);
+        if (it != memo.end()) {
+            return it->second;
+        }
+        resultado.evaluaciones++;
+        
+        // Reanudar desde el ultimo punto de control cuyo prefijo no cambia con este quantum
+        const PuntoControl* punto = nullptr;
+        for (const auto& candidato : puntosControl) {
+            if (candidato.quantumMinimo <= quantum) {
+                punto = &candidato;
+            }
+        }
+        EstadoRoundRobin estado = punto != nullptr ? punto->estado : iniciarRoundRobin(procesos);
+        if (punto != nullptr) {
+            resultado.pasosReutilizados += punto->pasos;
+        }
+        
+        size_t k = 0;
+        while (!terminoRoundRobin(estado)) {
+            while (k < periodos.size() && periodos[k].inicio < estado.tiempoActual) {
+                k++;
+            }
+            
+            if (k < periodos.size() && periodos[k].completadosAntes == estado.procesosCompletados &&
+                periodos[k].rafagaMaxima <= quantum) {
+                // Mismo estado inicial y ninguna interrupcion: se copia el periodo de la referencia
+                const PeriodoOcupacion& periodo = periodos[k++];
+                for (int i : periodo.procesos) {
+                    estado.procesos[i] = referencia.procesos[i];
+                    estado.tiempoRestante[i] = 0;
+                    estado.ultimaSalida[i] = referencia.ultimaSalida[i];
+                    estado.enCola[i] = false;
+                }
+                estado.colaListos = queue<int>();
+                estado.tiempoActual = periodo.fin;
+                estado.siguienteLlegada = upper_bound(llegadas.begin(), llegadas.end(), periodo.fin) -
+                                          llegadas.begin();
+                estado.procesosCompletados += periodo.procesos.size();
+                estado.ultimoProceso = periodo.ultimoProceso;
+                estado.cambiosContexto += periodo.cambiosContexto;
+                resultado.pasosReutilizados += periodo.pasos;
+                continue;
+            }
+            
+            pasoRoundRobin(estado, quantum, costo);
+            resultado.pasosSimulados++;
+        }
+        return memo[quantum] = evaluarObjetivo(estado, objetivo);
+    };
+    
+    // Acotar con el barrido geometrico
+    size_t mejorMuestra = 0;
+    for (size_t i = 0; i < muestras.size(); i++) {
+        if (evaluar(muestras[i]) < evaluar(muestras[mejorMuestra])) {
+            mejorMuestra = i;
+        }
+    }
+    
+    // Refinar con seccion aurea dentro del intervalo que rodea a la mejor muestra
+    int bajo = muestras[mejorMuestra > 0 ? mejorMuestra - 1 : 0];
+    int alto = muestras[min(mejorMuestra + 1, muestras.size() - 1)];
+    while (alto - bajo > 2) {
+        int medio1 = bajo + static_cast<int>((alto - bajo) * 0.382);
+        int medio2 = bajo + static_cast<int>((alto - bajo) * 0.618);
+        if (medio2 <= medio1) {
+            medio2 = medio1 + 1;
+        }
+        if (evaluar(medio1) <= evaluar(medio2)) {
+            alto = medio2;
+        } else {
+            bajo = medio1;
+        }
+    }
+    
+    resultado.quantum = muestras[mejorMuestra];
+    resultado.valor = evaluar(resultado.quantum);
+    for (int q = bajo; q <= alto; q++) {
+        if (evaluar(q) < resultado.valor ||
+            (evaluar(q) == resultado.valor && q < resultado.quantum)) {
+            resultado.quantum = q;
+            resultado.valor = evaluar(q);
+        }
+    }
+    
+    return resultado;
+}
+
+// Funcion para manejar planificacion de CPU
+void manejarPlanificacionCPU(const ModeloCosto& costo) {
+    ConfiguracionCPU configCPU = solicitarConfiguracionCPU(costo);
+    
+    if (configCPU.algoritmo.empty()) {
+        return; // Usuario cancelo
+    }
+    
+    vector<Proceso> procesos = solicitarProcesos();
+    
+    cout << "\nEjecutando simulacion de " << configCPU.algoritmo << "...\n";
+    ejecutarSimulacion(procesos, configCPU);
+    
+    mostrarTablaResultados(procesos);
+    pausar();
+}
+
+// Funcion para manejar gestion de memoria
+void manejarGestionMemoria() {
+    ConfiguracionMemoria configMemoria = solicitarConfiguracionMemoria();
+    
+    if (configMemoria.estrategia.empty()) {
         return; // Usuario cancelo
     }
     
@@ -691,13 +2173,167 @@ void manejarGestionMemoria() {
     
     cout << "\nSimulacion de memoria con estrategia " << configMemoria.estrategia 
          << " y tamaño " << configMemoria.tam << " bytes.\n";
-    cout << "Funcionalidad de memoria aun no implementada completamente.\n";
+    mostrarResultadosMemoria(simularMemoria(solicitudes, configMemoria));
+    
+    pausar();
+}
+
+// Funcion para solicitar el objetivo del optimizador de quantum
+ObjetivoQuantum solicitarObjetivoQuantum() {
+    ObjetivoQuantum objetivo;
+    int opcion;
+    
+    do {
+        cout << "\nMetrica a minimizar:\n";
+        cout << "1. Tiempo de Respuesta\n";
+        cout << "2. Tiempo de Espera\n";
+        cout << "3. Tiempo de Retorno\n";
+        cout << "Seleccione una metrica: ";
+        cin >> opcion;
+        limpiarBuffer();
+        
+        if (opcion < 1 || opcion > 3) {
+            cout << "Opcion invalida. Intente de nuevo.\n";
+        }
+    } while (opcion < 1 || opcion > 3);
+    objetivo.metrica = opcion == 1 ? "respuesta" : (opcion == 2 ? "espera" : "retorno");
+    
+    do {
+        cout << "\nEstadistico:\n";
+        cout << "1. Promedio\n";
+        cout << "2. Percentil 99\n";
+        cout << "Seleccione un estadistico: ";
+        cin >> opcion;
+        limpiarBuffer();
+        
+        if (opcion < 1 || opcion > 2) {
+            cout << "Opcion invalida. Intente de nuevo.\n";
+        }
+    } while (opcion < 1 || opcion > 2);
+    objetivo.estadistico = opcion == 1 ? "promedio" : "p99";
+    
+    do {
+        cout << "Penalizacion por cambio de contexto en el objetivo (0 para ignorarla): ";
+        cin >> objetivo.costoCambio;
+        
+        if (cin.fail() || objetivo.costoCambio < 0) {
+            cout << "Error: El costo debe ser un numero no negativo.\n";
+            limpiarBuffer();
+            objetivo.costoCambio = -1;
+        }
+    } while (objetivo.costoCambio < 0);
+    limpiarBuffer();
+    
+    return objetivo;
+}
+
+// Funcion para manejar la optimizacion del quantum de Round Robin
+void manejarOptimizacionQuantum(const ModeloCosto& costo) {
+    vector<Proceso> procesos = solicitarProcesos();
+    ObjetivoQuantum objetivo = solicitarObjetivoQuantum();
+    
+    cout << "\nBuscando el mejor quantum...\n";
+    ResultadoOptimizacion resultado = optimizarQuantum(procesos, objetivo, costo);
+    
+    cout << "\n=============================\n";
+    cout << "     QUANTUM OPTIMO\n";
+    cout << "=============================\n";
+    cout << "Quantum: " << resultado.quantum << endl;
+    cout << "Objetivo (" << objetivo.estadistico << " de " << objetivo.metrica << "): "
+         << fixed << setprecision(2) << resultado.valor << endl;
+    cout << "Quantums evaluados: " << resultado.evaluaciones << endl;
+    cout << "Pasos simulados: " << resultado.pasosSimulados
+         << " (reutilizados: " << resultado.pasosReutilizados << ")\n";
+    
+    simularRoundRobin(procesos, resultado.quantum, costo);
+    mostrarTablaResultados(procesos);
+    pausar();
+}
+
+// Funcion para manejar la simulacion de procesos con rafagas de CPU y E/S
+void manejarSimulacionES(const ModeloCosto& costo) {
+    ConfiguracionCPU configCPU = solicitarConfiguracionCPU(costo);
+    
+    if (configCPU.algoritmo.empty()) {
+        return; // Usuario cancelo
+    }
+    
+    vector<ProcesoES> procesos = solicitarProcesosES();
+    
+    int numCPUs;
+    do {
+        cout << "Numero de CPUs: ";
+        cin >> numCPUs;
+        
+        if (cin.fail() || numCPUs <= 0) {
+            cout << "Error: Debe ingresar un numero entero positivo.\n";
+            limpiarBuffer();
+            numCPUs = -1;
+        }
+    } while (numCPUs <= 0);
+    limpiarBuffer();
+    
+    cout << "\nEjecutando simulacion de " << configCPU.algoritmo << " con E/S...\n";
+    ResultadoES resultado = simularConES(procesos, configCPU, numCPUs);
+    
+    mostrarResultadosES(procesos, resultado);
+    pausar();
+}
+
+// Funcion para simulacion con varias CPUs y memoria compartida
+void simulacionMultiCPU(const ModeloCosto& costo) {
+    cout << "\n===============================\n";
+    cout << "     SIMULACION MULTI-CPU\n";
+    cout << "===============================\n";
+    
+    ConfiguracionCPU configCPU = solicitarConfiguracionCPUCompleta(costo);
+    vector<Proceso> procesos = solicitarProcesos();
+    ConfiguracionMemoria configMemoria = solicitarConfiguracionMemoriaCompleta();
+    vector<SolicitudMemoria> solicitudes = solicitarSolicitudesMemoria(procesos);
+    
+    int numCPUs;
+    do {
+        cout << "Numero de CPUs: ";
+        cin >> numCPUs;
+        
+        if (cin.fail() || numCPUs <= 0) {
+            cout << "Error: Debe ingresar un numero entero positivo.\n";
+            limpiarBuffer();
+            numCPUs = -1;
+        }
+    } while (numCPUs <= 0);
+    limpiarBuffer();
+    
+    if (configCPU.algoritmo == "priority") {
+        cout << "Algoritmo priority no implementado aun.\n";
+        pausar();
+        return;
+    }
+    
+    cout << "\nEjecutando simulacion en " << numCPUs << " CPUs...\n";
+    ResultadoMultiCPU resultado = simularMultiCPU(procesos, solicitudes, configCPU, configMemoria, numCPUs);
+    
+    mostrarTablaResultados(procesos);
+    
+    cout << "\n=============================\n";
+    cout << "       USO DE LAS CPUs\n";
+    cout << "=============================\n";
+    cout << "CPU | Procesos | Utilizacion | Overhead\n";
+    cout << "----+----------+-------------+---------\n";
+    double total = max(resultado.tiempoTotal, 1);
+    for (int cpu = 0; cpu < numCPUs; cpu++) {
+        cout << setw(3) << cpu << " |"
+             << setw(9) << resultado.procesosPorCPU[cpu] << " |"
+             << setw(11) << fixed << setprecision(2) << 100.0 * resultado.ocupacionCPU[cpu] / total << "% |"
+             << setw(8) << fixed << setprecision(2) << 100.0 * resultado.overheadCPU[cpu] / total << "%\n";
+    }
     
+    mostrarResultadosMemoria(resultado.memoria);
     pausar();
 }
 
 // Funcion para simulacion completa mejorada (usando la logica del segundo codigo)
-void simulacionCompleta() {
+void simulacionCompleta(const ModeloCosto& costo) {
     cout << "\n===============================\n";
     cout << "      SIMULACION COMPLETA\n";
     cout << "===============================\n";
@@ -705,7 +2341,7 @@ void simulacionCompleta() {
     
     try {
         // Solicitar configuracion de CPU usando el estilo del segundo codigo
-        ConfiguracionCPU configCPU = solicitarConfiguracionCPUCompleta();
+        ConfiguracionCPU configCPU = solicitarConfiguracionCPUCompleta(costo);
         
         if (configCPU.algoritmo.empty()) {
             return;
@@ -739,7 +2375,8 @@ void simulacionCompleta() {
         // Mostrar resultados de CPU
         mostrarTablaResultados(procesos);
         
-        cout << "\nGestion de memoria aun no implementada completamente.\n";
+        // Asignar la memoria al iniciar cada proceso y liberarla al terminar
+        mostrarResultadosMemoria(simularMemoriaTemporal(procesos, solicitudes, configMemoria));
         pausar();
         
     } catch (const exception& e) {
@@ -748,9 +2385,615 @@ void simulacionCompleta() {
     }
 }
 
-int main() {
-    int opcion;
+// Funcion para calcular un hash FNV-1a de 64 bits (contenido de cargas y claves de resultados)
+uint64_t hashFNV1a(const string& datos, uint64_t hash = 14695981039346656037ULL) {
+    for (unsigned char c : datos) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Funcion para leer una carga de trabajo desde archivo. Formato por linea ('#' inicia un comentario):
+//   P <pid> <llegada> <servicio>         proceso
+//   M <pid> <tam>                        memoria asignada al iniciar el proceso
+//   A <tiempo> <bloque> <pid> <tam>      asignacion en un tiempo dado
+//   L <tiempo> <bloque>                  liberacion de un bloque asignado con A
+//   R <tiempo> <bloque> <tam>            reasignacion de un bloque asignado con A
+// Lo que un proceso aun tenga asignado se libera cuando termina. Como el inicio y el fin de
+// cada proceso dependen de la planificacion, A, L y R se acotan a su vida al simular: si caen
+// antes de que inicie se aplican al iniciar, y si caen en su fin o despues se descartan.
+CargaTrabajo cargarCargaTrabajo(const string& texto, const string& ruta) {
+    CargaTrabajo carga;
+    carga.hash = hashFNV1a(texto);
+    unordered_map<int, int> solicitudPorBloque; // bloque del archivo -> indice de su solicitud A
+    unordered_set<int> pids;
+    
+    istringstream lineas(texto);
+    string linea;
+    int numeroLinea = 0;
+    while (getline(lineas, linea)) {
+        numeroLinea++;
+        size_t comentario = linea.find('#');
+        if (comentario != string::npos) {
+            linea.erase(comentario);
+        }
+        
+        istringstream campos(linea);
+        string tipo;
+        if (!(campos >> tipo)) {
+            continue;
+        }
+        
+        string error = "linea " + to_string(numeroLinea) + " de " + ruta + ": ";
+        if (tipo == "P" || tipo == "p") {
+            Proceso proceso;
+            if (!(campos >> proceso.pid >> proceso.llegada >> proceso.servicio) ||
+                proceso.pid <= 0 || proceso.llegada < 0 || proceso.servicio <= 0) {
+                throw runtime_error(error + "proceso invalido");
+            }
+            if (!pids.insert(proceso.pid).second) {
+                throw runtime_error(error + "el PID " + to_string(proceso.pid) + " ya existe");
+            }
+            carga.procesos.push_back(proceso);
+        } else if (tipo == "M" || tipo == "m") {
+            SolicitudMemoria solicitud;
+            if (!(campos >> solicitud.pid >> solicitud.tam) || solicitud.tam <= 0) {
+                throw runtime_error(error + "solicitud de memoria invalida");
+            }
+            carga.solicitudes.push_back(solicitud);
+        } else if (tipo == "A" || tipo == "a") {
+            SolicitudMemoria solicitud;
+            int bloque;
+            if (!(campos >> solicitud.tiempo >> bloque >> solicitud.pid >> solicitud.tam) ||
+                solicitud.tiempo < 0 || solicitud.tam <= 0) {
+                throw runtime_error(error + "asignacion invalida");
+            }
+            if (solicitudPorBloque.count(bloque)) {
+                throw runtime_error(error + "el bloque " + to_string(bloque) + " ya existe");
+            }
+            solicitudPorBloque[bloque] = carga.solicitudes.size();
+            carga.solicitudes.push_back(solicitud);
+        } else if (tipo == "L" || tipo == "l" || tipo == "R" || tipo == "r") {
+            SolicitudMemoria solicitud;
+            int bloque;
+            solicitud.tam = 0;
+            solicitud.tipo = (tipo == "L" || tipo == "l") ? LIBERAR : REASIGNAR;
+            if (!(campos >> solicitud.tiempo >> bloque) || solicitud.tiempo < 0 ||
+                (solicitud.tipo == REASIGNAR && (!(campos >> solicitud.tam) || solicitud.tam <= 0))) {
+                throw runtime_error(error + "liberacion o reasignacion invalida");
+            }
+            auto it = solicitudPorBloque.find(bloque);
+            if (it == solicitudPorBloque.end()) {
+                throw runtime_error(error + "el bloque " + to_string(bloque) + " no fue asignado antes");
+            }
+            solicitud.bloque = it->second;
+            solicitud.pid = carga.solicitudes[it->second].pid;
+            carga.solicitudes.push_back(solicitud);
+        } else {
+            throw runtime_error(error + "tipo de registro desconocido '" + tipo + "'");
+        }
+    }
+    
+    if (carga.procesos.empty()) {
+        throw runtime_error("la carga " + ruta + " no define procesos");
+    }
+    
+    for (const auto& solicitud : carga.solicitudes) {
+        if (!pids.count(solicitud.pid)) {
+            throw runtime_error("el PID " + to_string(solicitud.pid) + " de una solicitud de memoria no existe");
+        }
+    }
+    
+    return carga;
+}
+
+#ifndef _WIN32
+
+// Limites del modo servicio frente a clientes que envian datos arbitrarios
+const size_t MAX_LINEA_SERVICIO = 4096;
+const size_t MAX_CLIENTES_SERVICIO = 64;
+const time_t TIEMPO_INACTIVIDAD_SERVICIO = 30; // segundos sin leer ni escribir antes de cerrar
+const size_t MAX_CARGAS_SERVICIO = 16;        // archivos de carga interpretados en memoria
+const size_t MAX_RESULTADOS_SERVICIO = 100000; // respuestas memoizadas
+const int MAX_CPUS_SERVICIO = 1024;
+
+// Conexion abierta del modo servicio con lo que falta por interpretar y por enviar
+struct ClienteServicio {
+    int fd = -1;
+    string entrada;
+    string salida;
+    time_t ultimaActividad = 0;
+    bool finEntrada = false;
+    bool cerrar = false;
+};
+
+// Datos de stat que identifican una version de un archivo de carga
+struct FirmaArchivo {
+    long long modificacionSeg = 0;
+    long long modificacionNs = 0;
+    long long cambioSeg = 0;
+    long long cambioNs = 0;
+    long long tam = 0;
+    long long inodo = 0;
+    
+    bool operator==(const FirmaArchivo&) const = default;
+};
+
+// Carga en cache junto con la version del archivo de la que se leyo
+struct CargaEnCache {
+    CargaTrabajo carga;
+    FirmaArchivo firma;
+};
+
+// Estado del modo servicio: cargas ya leidas y resultados memoizados
+struct ServicioSimulacion {
+    unordered_map<string, CargaEnCache> cargas;
+    unordered_map<string, string> resultados;
+    long long aciertos = 0;
+    long long fallos = 0;
+};
+
+// Funcion para obtener la firma actual de un archivo (tiempos con nanosegundos)
+FirmaArchivo obtenerFirmaArchivo(const string& ruta) {
+    struct stat info;
+    if (stat(ruta.c_str(), &info) != 0) {
+        throw runtime_error("no se pudo abrir la carga " + ruta);
+    }
+    
+    FirmaArchivo firma;
+#ifdef __APPLE__
+    firma.modificacionSeg = info.st_mtimespec.tv_sec;
+    firma.modificacionNs = info.st_mtimespec.tv_nsec;
+    firma.cambioSeg = info.st_ctimespec.tv_sec;
+    firma.cambioNs = info.st_ctimespec.tv_nsec;
+#else
+    firma.modificacionSeg = info.st_mtim.tv_sec;
+    firma.modificacionNs = info.st_mtim.tv_nsec;
+    firma.cambioSeg = info.st_ctim.tv_sec;
+    firma.cambioNs = info.st_ctim.tv_nsec;
+#endif
+    firma.tam = info.st_size;
+    firma.inodo = info.st_ino;
+    return firma;
+}
+
+// Funcion para obtener una carga desde la cache. Si stat no muestra cambios se usa la copia
+// en memoria; si cambio, se lee el archivo y solo se vuelve a interpretar si su hash cambio.
+const CargaTrabajo& obtenerCargaTrabajo(ServicioSimulacion& servicio, const string& ruta) {
+    FirmaArchivo firma = obtenerFirmaArchivo(ruta);
+    auto it = servicio.cargas.find(ruta);
+    if (it != servicio.cargas.end() && it->second.firma == firma) {
+        return it->second.carga;
+    }
+    
+    ifstream archivo(ruta, ios::binary);
+    if (!archivo) {
+        throw runtime_error("no se pudo abrir la carga " + ruta);
+    }
+    
+    stringstream contenido;
+    contenido << archivo.rdbuf();
+    string texto = contenido.str();
     
+    if (it != servicio.cargas.end() && it->second.carga.hash == hashFNV1a(texto)) {
+        it->second.firma = firma;
+        return it->second.carga;
+    }
+    
+    CargaTrabajo carga = cargarCargaTrabajo(texto, ruta);
+    
+    // La version anterior de este archivo ya no se puede pedir: se olvidan sus resultados
+    if (it != servicio.cargas.end()) {
+        string prefijo = to_string(it->second.carga.hash) + "|";
+        for (auto r = servicio.resultados.begin(); r != servicio.resultados.end();) {
+            if (r->first.compare(0, prefijo.size(), prefijo) == 0) {
+                r = servicio.resultados.erase(r);
+            } else {
+                ++r;
+            }
+        }
+    } else if (servicio.cargas.size() >= MAX_CARGAS_SERVICIO) {
+        servicio.cargas.clear(); // Se vacia al llenarse; los resultados siguen validos por hash
+    }
+    
+    CargaEnCache& entrada = servicio.cargas[ruta];
+    entrada.carga = move(carga);
+    entrada.firma = firma;
+    return entrada.carga;
+}
+
+// Funcion para memoizar una respuesta; la tabla se vacia cuando llega a su limite
+void guardarResultado(ServicioSimulacion& servicio, const string& clave, const string& respuesta) {
+    if (servicio.resultados.size() >= MAX_RESULTADOS_SERVICIO) {
+        servicio.resultados.clear();
+    }
+    servicio.resultados[clave] = respuesta;
+}
+
+// Funcion para escribir un modelo de costo como parte de una clave de resultados
+string claveModeloCosto(const ModeloCosto& costo) {
+    return to_string(costo.despacho) + "," + to_string(costo.penalizacionCache) + "," +
+           to_string(costo.vidaMediaCache) + "," + to_string(costo.migracion);
+}
+
+// Funcion para atender una peticion del modo servicio y devolver la linea de respuesta.
+// Peticiones: "SIMULAR <carga> <algoritmo> <quantum> <tamMemoria> <estrategia> [cpus] [costo=d,p,v,m]",
+// "OPTIMIZAR <carga> <metrica> <estadistico> <costoCambio> [costo=d,p,v,m]", "ESTADO", "SALIR".
+string procesarPeticion(ServicioSimulacion& servicio, const string& linea, bool& detener) {
+    istringstream campos(linea);
+    string comando;
+    campos >> comando;
+    comando = toLowerCase(comando);
+    
+    if (comando == "salir") {
+        detener = true;
+        return "OK\n";
+    }
+    
+    if (comando == "estado") {
+        return "OK cargas=" + to_string(servicio.cargas.size()) +
+               " resultados=" + to_string(servicio.resultados.size()) +
+               " aciertos=" + to_string(servicio.aciertos) +
+               " fallos=" + to_string(servicio.fallos) + "\n";
+    }
+    
+    if (comando == "optimizar") {
+        string ruta;
+        ObjetivoQuantum objetivo;
+        ModeloCosto costo;
+        string opcion;
+        if (!(campos >> ruta >> objetivo.metrica >> objetivo.estadistico >> objetivo.costoCambio) ||
+            ((campos >> opcion) && !interpretarModeloCosto(opcion, costo)) || (campos >> opcion)) {
+            return "ERROR uso: OPTIMIZAR <carga> <metrica> <estadistico> <costoCambio> [costo=d,p,v,m]\n";
+        }
+        
+        objetivo.metrica = toLowerCase(objetivo.metrica);
+        objetivo.estadistico = toLowerCase(objetivo.estadistico);
+        if ((objetivo.metrica != "respuesta" && objetivo.metrica != "espera" && objetivo.metrica != "retorno") ||
+            (objetivo.estadistico != "promedio" && objetivo.estadistico != "p99") || objetivo.costoCambio < 0) {
+            return "ERROR objetivo no valido\n";
+        }
+        
+        try {
+            const CargaTrabajo& carga = obtenerCargaTrabajo(servicio, ruta);
+            ostringstream clave;
+            // 17 digitos significativos: dos costos distintos nunca comparten clave
+            clave << carga.hash << "|optimizar|" << objetivo.metrica << "|" << objetivo.estadistico
+                  << "|" << setprecision(17) << objetivo.costoCambio << "|" << claveModeloCosto(costo);
+            
+            auto it = servicio.resultados.find(clave.str());
+            if (it != servicio.resultados.end()) {
+                servicio.aciertos++;
+                return it->second + " cache=hit\n";
+            }
+            servicio.fallos++;
+            
+            ResultadoOptimizacion resultado = optimizarQuantum(carga.procesos, objetivo, costo);
+            ostringstream respuesta;
+            respuesta << fixed << setprecision(2)
+                      << "OK quantum=" << resultado.quantum
+                      << " valor=" << resultado.valor
+                      << " evaluaciones=" << resultado.evaluaciones
+                      << " pasos=" << resultado.pasosSimulados
+                      << " reutilizados=" << resultado.pasosReutilizados;
+            
+            guardarResultado(servicio, clave.str(), respuesta.str());
+            return respuesta.str() + " cache=miss\n";
+        } catch (const exception& e) {
+            return string("ERROR ") + e.what() + "\n";
+        }
+    }
+    
+    if (comando != "simular") {
+        return "ERROR comando desconocido\n";
+    }
+    
+    string ruta;
+    ConfiguracionCPU configCPU;
+    ConfiguracionMemoria configMemoria;
+    if (!(campos >> ruta >> configCPU.algoritmo >> configCPU.quantum >> configMemoria.tam >> configMemoria.estrategia)) {
+        return "ERROR uso: SIMULAR <carga> <algoritmo> <quantum> <tamMemoria> <estrategia> [cpus] [costo=d,p,v,m]\n";
+    }
+    
+    // Opcionales: numero de CPUs y el modelo de costo de los cambios de contexto
+    int numCPUs = 0;
+    bool conCPUs = false;
+    string opcion;
+    while (campos >> opcion) {
+        if (opcion.compare(0, 6, "costo=") == 0) {
+            if (!interpretarModeloCosto(opcion, configCPU.costo)) {
+                return "ERROR modelo de costo no valido\n";
+            }
+            continue;
+        }
+        
+        istringstream valor(opcion);
+        string resto;
+        if (conCPUs || !(valor >> numCPUs) || (valor >> resto)) {
+            return "ERROR uso: SIMULAR <carga> <algoritmo> <quantum> <tamMemoria> <estrategia> [cpus] [costo=d,p,v,m]\n";
+        }
+        conCPUs = true;
+    }
+    if (conCPUs && (numCPUs <= 0 || numCPUs > MAX_CPUS_SERVICIO)) {
+        return "ERROR cpus debe ser un entero entre 1 y " + to_string(MAX_CPUS_SERVICIO) + "\n";
+    }
+    
+    configCPU.algoritmo = toLowerCase(configCPU.algoritmo);
+    configMemoria.estrategia = toLowerCase(configMemoria.estrategia);
+    if (configCPU.algoritmo != "fcfs" && configCPU.algoritmo != "spn" && configCPU.algoritmo != "rr") {
+        return "ERROR algoritmo no valido\n";
+    }
+    if (configCPU.algoritmo == "rr" && configCPU.quantum <= 0) {
+        return "ERROR el quantum debe ser un numero entero positivo\n";
+    }
+    if (configCPU.algoritmo != "rr") {
+        configCPU.quantum = 0; // No se usa: configuraciones equivalentes comparten resultado
+    }
+    if (configMemoria.tam <= 0 || !esEstrategiaValida(configMemoria.estrategia)) {
+        return "ERROR configuracion de memoria no valida\n";
+    }
+    
+    try {
+        const CargaTrabajo& carga = obtenerCargaTrabajo(servicio, ruta);
+        
+        // Clave: hash del contenido de la carga mas la configuracion canonica
+        string clave = to_string(carga.hash) + "|" + configCPU.algoritmo + "|" +
+                       to_string(configCPU.quantum) + "|" + to_string(configMemoria.tam) + "|" +
+                       configMemoria.estrategia + "|" + to_string(numCPUs) + "|" +
+                       claveModeloCosto(configCPU.costo);
+        
+        auto it = servicio.resultados.find(clave);
+        if (it != servicio.resultados.end()) {
+            servicio.aciertos++;
+            return it->second + " cache=hit\n";
+        }
+        servicio.fallos++;
+        
+        vector<Proceso> procesos = carga.procesos;
+        ResultadoMemoria memoria;
+        if (numCPUs > 0) {
+            memoria = simularMultiCPU(procesos, carga.solicitudes, configCPU, configMemoria, numCPUs).memoria;
+        } else {
+            ejecutarSimulacion(procesos, configCPU);
+            memoria = simularMemoriaTemporal(procesos, carga.solicitudes, configMemoria);
+        }
+        Metricas metricas = calcularMetricas(procesos);
+        
+        ostringstream respuesta;
+        respuesta << fixed << setprecision(2)
+                  << "OK respuesta=" << metricas.promedioRespuesta
+                  << " espera=" << metricas.promedioEspera
+                  << " retorno=" << metricas.promedioRetorno
+                  << " overhead=" << metricas.promedioOverhead
+                  << " asignadas=" << memoria.asignadas
+                  << " fallidas=" << memoria.fallidas
+                  << " liberadas=" << memoria.liberadas
+                  << " reasignadas=" << memoria.reasignadas
+                  << " descartadas=" << memoria.descartadas
+                  << " usada=" << memoria.memoriaUsada
+                  << " maximo=" << memoria.usoMaximo
+                  << " libre=" << memoria.memoriaLibre
+                  << " tasaFallos=" << calcularTasaFallos(memoria)
+                  << " pasos=" << calcularPasosPromedio(memoria)
+                  << " pasosMax=" << memoria.pasosMaximos;
+        
+        guardarResultado(servicio, clave, respuesta.str());
+        return respuesta.str() + " cache=miss\n";
+    } catch (const exception& e) {
+        return string("ERROR ") + e.what() + "\n";
+    }
+}
+
+// Se activa con SIGINT o SIGTERM para que el servicio salga del bucle y borre su socket
+volatile sig_atomic_t servicioInterrumpido = 0;
+
+void interrumpirServicio(int) {
+    servicioInterrumpido = 1;
+}
+
+// Funcion para ejecutar el simulador como servicio en un socket de dominio Unix
+int ejecutarServicio(const string& rutaSocket) {
+    sockaddr_un direccion = {};
+    direccion.sun_family = AF_UNIX;
+    if (rutaSocket.size() >= sizeof(direccion.sun_path)) {
+        cout << "Error: La ruta del socket es demasiado larga.\n";
+        return 1;
+    }
+    rutaSocket.copy(direccion.sun_path, rutaSocket.size());
+    
+    // Solo se reemplaza un socket abandonado; cualquier otro archivo en la ruta se conserva
+    struct stat info;
+    if (lstat(rutaSocket.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            cout << "Error: " << rutaSocket << " existe y no es un socket.\n";
+            return 1;
+        }
+        
+        int prueba = socket(AF_UNIX, SOCK_STREAM, 0);
+        bool enUso = prueba >= 0 &&
+                     connect(prueba, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) == 0;
+        if (prueba >= 0) {
+            close(prueba);
+        }
+        if (enUso) {
+            cout << "Error: Ya hay un servicio escuchando en " << rutaSocket << ".\n";
+            return 1;
+        }
+        unlink(rutaSocket.c_str());
+    }
+    
+    // Un cliente que se desconecta antes de leer la respuesta no debe terminar el servicio
+    signal(SIGPIPE, SIG_IGN);
+    
+    // Sin SA_RESTART: poll vuelve con EINTR y el bucle ve la interrupcion
+    struct sigaction accion = {};
+    accion.sa_handler = interrumpirServicio;
+    sigemptyset(&accion.sa_mask);
+    sigaction(SIGINT, &accion, nullptr);
+    sigaction(SIGTERM, &accion, nullptr);
+    
+    int servidor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (servidor < 0) {
+        cout << "Error: No se pudo crear el socket.\n";
+        return 1;
+    }
+    
+    if (bind(servidor, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) < 0 ||
+        listen(servidor, 16) < 0) {
+        cout << "Error: No se pudo escuchar en " << rutaSocket << ".\n";
+        close(servidor);
+        return 1;
+    }
+    
+    cout << "Servicio de simulacion escuchando en " << rutaSocket << endl;
+    
+    // El servidor y los clientes no bloquean: un cliente lento o inactivo no detiene a los demas
+    fcntl(servidor, F_SETFL, fcntl(servidor, F_GETFL) | O_NONBLOCK);
+    
+    ServicioSimulacion servicio;
+    vector<ClienteServicio> clientes;
+    bool detener = false;
+    while (!detener && !servicioInterrumpido) {
+        vector<pollfd> sondeo;
+        sondeo.push_back({servidor, POLLIN, 0});
+        for (const auto& cliente : clientes) {
+            short eventos = cliente.salida.empty() ? POLLIN : POLLIN | POLLOUT;
+            sondeo.push_back({cliente.fd, eventos, 0});
+        }
+        
+        if (poll(sondeo.data(), sondeo.size(), 1000) < 0) {
+            continue; // EINTR: se revisa la interrupcion en la condicion del bucle
+        }
+        time_t ahora = time(nullptr);
+        
+        for (size_t c = 0; c < clientes.size() && !detener; c++) {
+            ClienteServicio& cliente = clientes[c];
+            short eventos = sondeo[c + 1].revents;
+            
+            if (eventos & (POLLIN | POLLHUP | POLLERR)) {
+                char buffer[4096];
+                ssize_t leidos = read(cliente.fd, buffer, sizeof(buffer));
+                if (leidos > 0) {
+                    cliente.entrada.append(buffer, leidos);
+                    cliente.ultimaActividad = ahora;
+                } else if (leidos == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    cliente.finEntrada = true;
+                }
+            }
+            
+            // Un cliente puede enviar varias peticiones, una por linea
+            size_t finLinea;
+            while (!detener && !cliente.cerrar && (finLinea = cliente.entrada.find('\n')) != string::npos) {
+                string linea = cliente.entrada.substr(0, finLinea);
+                cliente.entrada.erase(0, finLinea + 1);
+                if (!linea.empty() && linea.back() == '\r') {
+                    linea.pop_back();
+                }
+                if (linea.size() > MAX_LINEA_SERVICIO) {
+                    cliente.salida += "ERROR linea demasiado larga\n";
+                    cliente.cerrar = true;
+                } else if (!linea.empty()) {
+                    cliente.salida += procesarPeticion(servicio, linea, detener);
+                }
+            }
+            if (cliente.entrada.size() > MAX_LINEA_SERVICIO) {
+                cliente.salida += "ERROR linea demasiado larga\n";
+                cliente.cerrar = true;
+                cliente.entrada.clear();
+            }
+            if (cliente.finEntrada) {
+                cliente.cerrar = true;
+            }
+            
+            if (!cliente.salida.empty()) {
+                ssize_t enviados = send(cliente.fd, cliente.salida.data(), cliente.salida.size(), MSG_NOSIGNAL);
+                if (enviados > 0) {
+                    cliente.salida.erase(0, enviados);
+                    cliente.ultimaActividad = ahora;
+                } else if (enviados < 0 && errno != EAGAIN && errno != EINTR) {
+                    cliente.salida.clear();
+                    cliente.cerrar = true;
+                }
+            }
+            
+            if (ahora - cliente.ultimaActividad > TIEMPO_INACTIVIDAD_SERVICIO) {
+                cliente.salida.clear();
+                cliente.cerrar = true;
+            }
+        }
+        
+        // Se cierran los clientes que terminaron y ya recibieron todas sus respuestas
+        for (size_t c = 0; c < clientes.size();) {
+            if (clientes[c].cerrar && clientes[c].salida.empty()) {
+                close(clientes[c].fd);
+                clientes.erase(clientes.begin() + c);
+            } else {
+                c++;
+            }
+        }
+        
+        if (sondeo[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept(servidor, nullptr, nullptr)) >= 0) {
+                if (clientes.size() >= MAX_CLIENTES_SERVICIO) {
+                    close(fd);
+                    continue;
+                }
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                ClienteServicio cliente;
+                cliente.fd = fd;
+                cliente.ultimaActividad = ahora;
+                clientes.push_back(cliente);
+            }
+        }
+    }
+    
+    // Al detenerse se intenta entregar lo pendiente (por ejemplo el OK de SALIR)
+    for (auto& cliente : clientes) {
+        if (!cliente.salida.empty()) {
+            send(cliente.fd, cliente.salida.data(), cliente.salida.size(), MSG_NOSIGNAL);
+        }
+        close(cliente.fd);
+    }
+    
+    close(servidor);
+    unlink(rutaSocket.c_str());
+    return 0;
+}
+
+#endif
+
+int main(int argc, char* argv[]) {
+    // Modo servicio: SIMULACION_SOI --servicio <ruta del socket>
+    if (argc >= 2 && string(argv[1]) == "--servicio") {
+#ifndef _WIN32
+        if (argc < 3) {
+            cout << "Uso: " << argv[0] << " --servicio <ruta del socket>\n";
+            return 1;
+        }
+        return ejecutarServicio(argv[2]);
+#else
+        cout << "El modo servicio requiere sockets de dominio Unix y no esta disponible en Windows.\n";
+        return 1;
+#endif
+    }
+    
+    // Modelo de costo de los cambios de contexto: SIMULACION_SOI --costo=d,p,v,m
+    ModeloCosto costo;
+    if (argc >= 2) {
+        string opcionCosto = argv[1];
+        if (argc > 2 || opcionCosto.compare(0, 2, "--") != 0 || !interpretarModeloCosto(opcionCosto.substr(2), costo)) {
+            cout << "Uso: " << argv[0] << " [--costo=<despacho>,<penalizacion>,<vidaMedia>,<migracion>]\n";
+            cout << "     " << argv[0] << " --servicio <ruta del socket>\n";
+            return 1;
+        }
+        cout << "Modelo de costo: despacho " << costo.despacho << ", cache fria " << costo.penalizacionCache
+             << ", vida media " << costo.vidaMediaCache << ", migracion " << costo.migracion << "\n";
+    }
+    
+    int opcion;
+
     do {
         mostrarMenuPrincipal();
         cin >> opcion;
@@ -758,17 +3001,26 @@ int main() {
         
         switch (opcion) {
             case 1:
-                manejarPlanificacionCPU();
+                manejarPlanificacionCPU(costo);
                 break;
             case 2:
                 manejarGestionMemoria();
                 break;
             case 3:
-                simulacionCompleta();
+                simulacionCompleta(costo);
                 break;
             case 4:
                 cout << "\nGracias por usar el Simulador de Sistema Operativo!\n";
                 break;
+            case 5:
+                manejarOptimizacionQuantum(costo);
+                break;
+            case 6:
+                manejarSimulacionES(costo);
+                break;
+            case 7:
+                simulacionMultiCPU(costo);
+                break;
             default:
                 cout << "\nOpcion invalida. Por favor seleccione una opcion valida.\n";
                 pausar();